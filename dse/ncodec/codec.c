@@ -5,6 +5,11 @@
 #include <dse/ncodec/codec.h>
 
 
+/* Build option NCODEC_FAST_PATH: the message API (write, read, flush and
+   truncate) calls the codec directly, without guard conditions or dispatch
+   to the trace and instrumentation interfaces. */
+
+
 /**
 ncodec_load
 ===========
@@ -184,14 +189,20 @@ Returns
 */
 inline int32_t ncodec_write(NCODEC* nc, NCodecMessage* msg)
 {
+#ifdef NCODEC_FAST_PATH
+    return ((NCodecInstance*)nc)->codec.write(nc, msg);
+#else
     NCodecInstance* _nc = (NCodecInstance*)nc;
     if (_nc && _nc->codec.write) {
+        if (_nc->instrument.begin) _nc->instrument.begin(nc, NCODEC_OP_WRITE);
         int32_t rc = _nc->codec.write(nc, msg);
+        if (_nc->instrument.end) _nc->instrument.end(nc, NCODEC_OP_WRITE, rc);
         if (_nc->trace.write && (rc > 0)) _nc->trace.write(nc, msg);
         return rc;
     } else {
         return -ENOSTR;
     }
+#endif
 }
 
 
@@ -238,15 +249,192 @@ Returns
 */
 inline int32_t ncodec_read(NCODEC* nc, NCodecMessage* msg)
 {
+#ifdef NCODEC_FAST_PATH
+    return ((NCodecInstance*)nc)->codec.read(nc, msg);
+#else
     NCodecInstance* _nc = (NCodecInstance*)nc;
     if (_nc && _nc->codec.read) {
+        if (_nc->instrument.begin) _nc->instrument.begin(nc, NCODEC_OP_READ);
         int32_t rc = _nc->codec.read(nc, msg);
+        if (_nc->instrument.end) _nc->instrument.end(nc, NCODEC_OP_READ, rc);
         if (_nc->trace.read && (rc > 0)) _nc->trace.read(nc, msg);
         return rc;
     } else {
         msg = NULL;
         return -ENOMSG;
     }
+#endif
+}
+
+
+/**
+ncodec_write_batch
+==================
+
+Write an array of messages to the Network Codec object. When the codec
+implements a native batch interface, all messages are encoded with a single
+call to the codec, otherwise each message is written with a call to the
+codec `write` method. When a trace interface is configured, each message is
+written (and traced) as with `ncodec_write`.
+
+Writing stops at the first message which could not be written.
+
+The caller owns the message buffer/memory and the codec implementation will
+encode (i.e. duplicate) the content of each message during this call.
+
+Parameters
+----------
+nc (NCODEC*)
+: Network Codec object.
+
+msgs (NCodecMessage*)
+: Array of message representations to write to the Network Codec. Caller owns
+  the message buffer/memory. Message type is defined by the codec
+  implementation.
+
+count (size_t)
+: The number of messages in the `msgs` array (limited to INT32_MAX).
+
+size (size_t)
+: The size of each message in the `msgs` array (i.e. `sizeof(NCodecPdu)`).
+
+Returns
+-------
++VE (int32_t)
+: The number of messages written to the Network Codec. When fewer than
+  `count`, the next message could not be written.
+
+-ENOSTR (-60)
+: The object represented by `nc` does not represent a valid stream.
+
+-EINVAL (-22)
+: Bad `msgs` argument.
+*/
+inline int32_t ncodec_write_batch(
+    NCODEC* nc, NCodecMessage* msgs, size_t count, size_t size)
+{
+    NCodecInstance* _nc = (NCodecInstance*)nc;
+    if (_nc == NULL) return -ENOSTR;
+    if (msgs == NULL || size == 0) return -EINVAL;
+    if (count > INT32_MAX) count = INT32_MAX;
+
+    int32_t          rc;
+    NCodecTraceWrite trace = NULL;
+#ifndef NCODEC_FAST_PATH
+    trace = _nc->trace.write;
+    if (_nc->instrument.begin) {
+        _nc->instrument.begin(nc, NCODEC_OP_WRITE_BATCH);
+    }
+#endif
+    if (_nc->batch.write && trace == NULL) {
+        rc = _nc->batch.write(nc, msgs, count, size);
+    } else if (_nc->codec.write) {
+        for (rc = 0; (size_t)rc < count; rc++) {
+            NCodecMessage* msg = (uint8_t*)msgs + rc * size;
+            int32_t        _rc = _nc->codec.write(nc, msg);
+            if (_rc < 0) {
+                if (rc == 0) rc = _rc;
+                break;
+            }
+            if (trace && (_rc > 0)) trace(nc, msg);
+        }
+    } else {
+        rc = -ENOSTR;
+    }
+#ifndef NCODEC_FAST_PATH
+    if (_nc->instrument.end) {
+        _nc->instrument.end(nc, NCODEC_OP_WRITE_BATCH, rc);
+    }
+#endif
+    return rc;
+}
+
+
+/**
+ncodec_read_batch
+=================
+
+Read up to `count` messages from a Network Codec into the provided array.
+When the codec implements a native batch interface, all messages are decoded
+with a single call to the codec, otherwise each message is read with a call
+to the codec `read` method. When a trace interface is configured, each message
+is read (and traced) as with `ncodec_read`.
+
+The codec owns the message buffer/memory referenced by the returned messages
+(same conditions as for `ncodec_read`).
+
+Parameters
+----------
+nc (NCODEC*)
+: Network Codec object.
+
+msgs (NCodecMessage*)
+: (out) Array of message representations which will be set by the Network
+  Codec. Caller owns the array. Message type is defined by the codec
+  implementation.
+
+count (size_t)
+: The number of messages in the `msgs` array (limited to INT32_MAX).
+
+size (size_t)
+: The size of each message in the `msgs` array (i.e. `sizeof(NCodecPdu)`).
+
+Returns
+-------
++VE (int32_t)
+: The number of messages read from the Network Codec. Additional messages may
+  remain on the Network Codec, repeat calls to `ncodec_read_batch` until
+  -ENOMSG is returned.
+
+-ENOMSG (-42)
+: No message is available from the Network Codec.
+
+-ENOSTR (-60)
+: The object represented by `nc` does not represent a valid stream.
+
+-ENOSR (-63)
+: No stream resource has been configured.
+
+-EINVAL (-22)
+: Bad `msgs` argument.
+*/
+inline int32_t ncodec_read_batch(
+    NCODEC* nc, NCodecMessage* msgs, size_t count, size_t size)
+{
+    NCodecInstance* _nc = (NCodecInstance*)nc;
+    if (_nc == NULL) return -ENOMSG;
+    if (msgs == NULL || size == 0) return -EINVAL;
+    if (count > INT32_MAX) count = INT32_MAX;
+
+    int32_t         rc;
+    NCodecTraceRead trace = NULL;
+#ifndef NCODEC_FAST_PATH
+    trace = _nc->trace.read;
+    if (_nc->instrument.begin) {
+        _nc->instrument.begin(nc, NCODEC_OP_READ_BATCH);
+    }
+#endif
+    if (_nc->batch.read && trace == NULL) {
+        rc = _nc->batch.read(nc, msgs, count, size);
+    } else if (_nc->codec.read) {
+        for (rc = 0; (size_t)rc < count; rc++) {
+            NCodecMessage* msg = (uint8_t*)msgs + rc * size;
+            int32_t        _rc = _nc->codec.read(nc, msg);
+            if (_rc < 0) {
+                if (rc == 0) rc = _rc;
+                break;
+            }
+            if (trace && (_rc > 0)) trace(nc, msg);
+        }
+    } else {
+        rc = -ENOMSG;
+    }
+#ifndef NCODEC_FAST_PATH
+    if (_nc->instrument.end) {
+        _nc->instrument.end(nc, NCODEC_OP_READ_BATCH, rc);
+    }
+#endif
+    return rc;
 }
 
 
@@ -272,12 +460,19 @@ Returns
 */
 inline int32_t ncodec_flush(NCODEC* nc)
 {
+#ifdef NCODEC_FAST_PATH
+    return ((NCodecInstance*)nc)->codec.flush(nc);
+#else
     NCodecInstance* _nc = (NCodecInstance*)nc;
     if (_nc && _nc->codec.flush) {
-        return _nc->codec.flush(nc);
+        if (_nc->instrument.begin) _nc->instrument.begin(nc, NCODEC_OP_FLUSH);
+        int32_t rc = _nc->codec.flush(nc);
+        if (_nc->instrument.end) _nc->instrument.end(nc, NCODEC_OP_FLUSH, rc);
+        return rc;
     } else {
         return -ENOSTR;
     }
+#endif
 }
 
 
@@ -303,12 +498,23 @@ Returns
 */
 inline int32_t ncodec_truncate(NCODEC* nc)
 {
+#ifdef NCODEC_FAST_PATH
+    return ((NCodecInstance*)nc)->codec.truncate(nc);
+#else
     NCodecInstance* _nc = (NCodecInstance*)nc;
     if (_nc && _nc->codec.truncate) {
-        return _nc->codec.truncate(nc);
+        if (_nc->instrument.begin) {
+            _nc->instrument.begin(nc, NCODEC_OP_TRUNCATE);
+        }
+        int32_t rc = _nc->codec.truncate(nc);
+        if (_nc->instrument.end) {
+            _nc->instrument.end(nc, NCODEC_OP_TRUNCATE, rc);
+        }
+        return rc;
     } else {
         return -ENOSTR;
     }
+#endif
 }
 
 
@@ -392,6 +598,9 @@ nc (NCODEC*)
 inline void ncodec_close(NCODEC* nc)
 {
     NCodecInstance* _nc = (NCodecInstance*)nc;
+    if (_nc && _nc->instrument.close) {
+        _nc->instrument.close(nc);
+    }
     if (_nc && _nc->stream && _nc->stream->close) {
         _nc->stream->close(nc);
     }
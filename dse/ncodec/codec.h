@@ -25,6 +25,12 @@
 #endif /* _WIN32 || defined __CYGWIN__ */
 
 
+/* ABI version of the NCodec API, incremented when the layout of the types
+   shared by codecs and integrators changes (version 2: the extensions of
+   NCodecInstance). Codecs and integrators must use the same version. */
+#define NCODEC_ABI_VERSION 2
+
+
 /**
 Network Codec
 =============
@@ -121,6 +127,8 @@ typedef int64_t (*NCodecStreamSeek)(NCODEC* nc, size_t pos, int32_t op);
 typedef int64_t (*NCodecStreamTell)(NCODEC* nc);
 typedef int32_t (*NCodecStreamEof)(NCODEC* nc);
 typedef int32_t (*NCodecStreamClose)(NCODEC* nc);
+typedef int32_t (*NCodecStreamReserve)(NCODEC* nc, size_t len, uint8_t** data);
+typedef int32_t (*NCodecStreamCommit)(NCODEC* nc, size_t len);
 
 typedef struct NCodecStreamVTable {
     NCodecStreamRead  read;
@@ -131,6 +139,17 @@ typedef struct NCodecStreamVTable {
     NCodecStreamClose close;
 } NCodecStreamVTable;
 
+/* Stream extension interface (optional). The extension is versioned by its
+   size (set by the stream), members beyond `size` are not used. */
+typedef struct NCodecStreamExtVTable {
+    size_t              size;
+    /* Zero-copy write interface. A reservation is published by commit, a
+       reservation which is not committed is abandoned (replaced by the next
+       reservation). */
+    NCodecStreamReserve reserve;
+    NCodecStreamCommit  commit;
+} NCodecStreamExtVTable;
+
 
 /** CODEC Interface */
 
@@ -150,6 +169,10 @@ typedef int32_t (*NCodecConfig)(NCODEC* nc, NCodecConfigItem item);
 typedef NCodecConfigItem (*NCodecStat)(NCODEC* nc, int32_t* index);
 typedef int32_t (*NCodecWrite)(NCODEC* nc, NCodecMessage* msg);
 typedef int32_t (*NCodecRead)(NCODEC* nc, NCodecMessage* msg);
+typedef int32_t (*NCodecWriteBatch)(
+    NCODEC* nc, NCodecMessage* msgs, size_t count, size_t size);
+typedef int32_t (*NCodecReadBatch)(
+    NCODEC* nc, NCodecMessage* msgs, size_t count, size_t size);
 typedef int32_t (*NCodecFlush)(NCODEC* nc);
 typedef int32_t (*NCodecTruncate)(NCODEC* nc);
 typedef void (*NCodecClose)(NCODEC* nc);
@@ -164,6 +187,11 @@ typedef struct NCodecVTable {
     NCodecClose    close;
 } NCodecVTable;
 
+typedef struct NCodecBatchVTable {
+    NCodecWriteBatch write;
+    NCodecReadBatch  read;
+} NCodecBatchVTable;
+
 typedef void (*NCodecTraceWrite)(NCODEC* nc, NCodecMessage* msg);
 typedef void (*NCodecTraceRead)(NCODEC* nc, NCodecMessage* msg);
 
@@ -172,6 +200,28 @@ typedef struct NCodecTraceVTable {
     NCodecTraceRead  read;
 } NCodecTraceVTable;
 
+typedef enum NCodecOperation {
+    NCODEC_OP_WRITE = 0,
+    NCODEC_OP_READ,
+    NCODEC_OP_WRITE_BATCH,
+    NCODEC_OP_READ_BATCH,
+    NCODEC_OP_FLUSH,
+    NCODEC_OP_TRUNCATE,
+    __NCODEC_OP_COUNT__,
+} NCodecOperation;
+
+typedef void (*NCodecInstrumentBegin)(NCODEC* nc, int32_t op);
+typedef void (*NCodecInstrumentEnd)(NCODEC* nc, int32_t op, int32_t rc);
+typedef void (*NCodecInstrumentClose)(NCODEC* nc);
+
+typedef struct NCodecInstrumentVTable {
+    NCodecInstrumentBegin begin;
+    NCodecInstrumentEnd   end;
+    NCodecInstrumentClose close;
+    /* Private reference data of the instrumentation (optional). */
+    void*                 data;
+} NCodecInstrumentVTable;
+
 
 typedef struct NCodecInstance {
     const char*         mime_type;
@@ -181,6 +231,16 @@ typedef struct NCodecInstance {
     NCodecTraceVTable   trace;
     /* Private reference data from API user (optional). */
     void* private;
+    /* Extensions (NCODEC_ABI_VERSION 2). The preceding fields keep their
+       offsets, however codecs embed NCodecInstance (as their first member) so
+       the private fields of a codec built against an earlier version of this
+       header overlay these extensions; such codecs must be rebuilt. */
+    /* Instrumentation interface (optional). */
+    NCodecInstrumentVTable instrument;
+    /* Batch interface (optional). */
+    NCodecBatchVTable      batch;
+    /* Stream extension interface (optional, set by the integrator). */
+    NCodecStreamExtVTable* stream_ext;
 } NCodecInstance;
 
 
@@ -197,6 +257,10 @@ DLL_PUBLIC void             ncodec_config(NCODEC* nc, NCodecConfigItem item);
 DLL_PUBLIC NCodecConfigItem ncodec_stat(NCODEC* nc, int32_t* index);
 DLL_PUBLIC int32_t          ncodec_write(NCODEC* nc, NCodecMessage* msg);
 DLL_PUBLIC int32_t          ncodec_read(NCODEC* nc, NCodecMessage* msg);
+DLL_PUBLIC int32_t          ncodec_write_batch(
+    NCODEC* nc, NCodecMessage* msgs, size_t count, size_t size);
+DLL_PUBLIC int32_t          ncodec_read_batch(
+    NCODEC* nc, NCodecMessage* msgs, size_t count, size_t size);
 DLL_PUBLIC int32_t          ncodec_flush(NCODEC* nc);
 DLL_PUBLIC int32_t          ncodec_truncate(NCODEC* nc);
 DLL_PUBLIC void             ncodec_close(NCODEC* nc);
@@ -2,27 +2,45 @@
 //
 // SPDX-License-Identifier: Apache-2.0
 
+#include <stddef.h>
+#include <stdio.h>
 #include <stdlib.h>
 #include <stdint.h>
 #include <string.h>
 #include <ctype.h>
+#include <errno.h>
 #include <dse/ncodec/codec.h>
 #include <dse/ncodec/codec/ab/codec.h>
 
 
-#define UNUSED(x) ((void)x)
-#define CODEC     "application/x-automotive-bus"
+#define UNUSED(x)     ((void)x)
+#define ARRAY_SIZE(x) (sizeof(x) / sizeof(x[0]))
+#define CODEC         "application/x-automotive-bus"
+
+#define ARENA_ALIGN      16
+#define ARENA_CHUNK_SIZE 4096
+
+#define INDEX_MIN_CAPACITY 16
+#define INDEX_NOT_FOUND    SIZE_MAX
 
 
 /* interface=stream; type=frame; bus=can; schema=fbs */
 extern int32_t can_write(NCODEC* nc, NCodecMessage* msg);
 extern int32_t can_read(NCODEC* nc, NCodecMessage* msg);
+extern int32_t can_write_batch(
+    NCODEC* nc, NCodecMessage* msgs, size_t count, size_t size);
+extern int32_t can_read_batch(
+    NCODEC* nc, NCodecMessage* msgs, size_t count, size_t size);
 extern int32_t can_flush(NCODEC* nc);
 extern int32_t can_truncate(NCODEC* nc);
 
 /* interface=stream; type=pdu; schema=fbs */
 extern int32_t pdu_write(NCODEC* nc, NCodecMessage* msg);
 extern int32_t pdu_read(NCODEC* nc, NCodecMessage* msg);
+extern int32_t pdu_write_batch(
+    NCODEC* nc, NCodecMessage* msgs, size_t count, size_t size);
+extern int32_t pdu_read_batch(
+    NCODEC* nc, NCodecMessage* msgs, size_t count, size_t size);
 extern int32_t pdu_flush(NCODEC* nc);
 extern int32_t pdu_truncate(NCODEC* nc);
 
@@ -41,6 +59,579 @@ char* trim(char* s)
 }
 
 
+static void* _arena_bump(ABArena* arena, size_t size)
+{
+    size = (size + ARENA_ALIGN - 1) & ~(size_t)(ARENA_ALIGN - 1);
+    ABArenaChunk* c = arena->chunks;
+    if (c == NULL || c->size - c->used < size) {
+        /* New chunk, at least double the size of the previous chunk. */
+        size_t chunk_size = arena->chunk_size;
+        if (c && chunk_size < c->size * 2) chunk_size = c->size * 2;
+        if (chunk_size < size) chunk_size = size;
+        c = malloc(sizeof(ABArenaChunk) + chunk_size);
+        if (c == NULL) return NULL;
+        c->next = arena->chunks;
+        c->size = chunk_size;
+        c->used = 0;
+        arena->chunks = c;
+    }
+    void* p = c->data + c->used;
+    c->used += size;
+    return p;
+}
+
+
+/* Release a block to the free list (blocks smaller than a list entry are only
+   released when the arena is destroyed). */
+static void _arena_release(ABArena* arena, void* base, size_t size)
+{
+    if (base == NULL || size < sizeof(ABArenaBlock)) return;
+
+    ABArenaBlock* block = base;
+    block->next = arena->free_list;
+    block->size = size;
+    arena->free_list = block;
+}
+
+
+/* Take the smallest block, from the free list, of at least `*size` bytes. The
+   size of the block is returned via `size`. */
+static void* _arena_reuse(ABArena* arena, size_t* size)
+{
+    ABArenaBlock** best = NULL;
+    for (ABArenaBlock** p = &arena->free_list; *p; p = &(*p)->next) {
+        if ((*p)->size < *size) continue;
+        if (best == NULL || (*p)->size < (*best)->size) best = p;
+    }
+    if (best == NULL) return NULL;
+
+    ABArenaBlock* block = *best;
+    *best = block->next;
+    *size = block->size;
+    return block;
+}
+
+
+/* Allocator (flatcc_builder_alloc_fun) for the flatcc builder. Builder buffers
+   are grown (never shrunk) and retained across builder resets, so once the
+   buffers have reached their working size no further allocations are made.
+   When a buffer is moved (to grow) its previous block is released to the
+   free list and reused by later requests, chunk memory is not returned to
+   the system, so the arena holds its high-water size until destroyed. */
+DLL_PRIVATE int arena_alloc(void* alloc_context, flatcc_iovec_t* b,
+    size_t request, int zero_fill, int alloc_type)
+{
+    ABArena* arena = alloc_context;
+
+    if (request == 0) {
+        _arena_release(arena, b->iov_base, b->iov_len);
+        b->iov_base = NULL;
+        b->iov_len = 0;
+        return 0;
+    }
+    if (request <= b->iov_len) return 0;
+
+    size_t n = (alloc_type == flatcc_builder_alloc_ht) ? request : 32;
+    while (n < request)
+        n *= 2;
+    n = (n + ARENA_ALIGN - 1) & ~(size_t)(ARENA_ALIGN - 1);
+
+    ABArenaChunk* c = arena->chunks;
+    uint8_t*      base = b->iov_base;
+    if (c && base && base + b->iov_len == c->data + c->used &&
+        (c->size - c->used) >= (n - b->iov_len)) {
+        /* Last allocation of the chunk, extend in place. */
+        c->used += n - b->iov_len;
+    } else {
+        size_t   size = n;
+        uint8_t* p = _arena_reuse(arena, &size);
+        if (p == NULL) p = _arena_bump(arena, n);
+        if (p == NULL) return -1;
+        if (base) {
+            memcpy(p, base, b->iov_len);
+            _arena_release(arena, base, b->iov_len);
+        }
+        b->iov_base = p;
+        n = size;
+    }
+    if (zero_fill) memset((uint8_t*)b->iov_base + b->iov_len, 0, n - b->iov_len);
+    b->iov_len = n;
+    return 0;
+}
+
+
+DLL_PRIVATE void arena_destroy(ABArena* arena)
+{
+    ABArenaChunk* c = arena->chunks;
+    while (c) {
+        ABArenaChunk* next = c->next;
+        free(c);
+        c = next;
+    }
+    arena->chunks = NULL;
+    arena->free_list = NULL;
+}
+
+
+/* Grow the emitter block so that `front_len` bytes can be emitted before, and
+   `back_len` bytes after, the current buffer. The buffer is moved to a new
+   block (allocated with malloc, not via the builder allocator) with a quarter
+   of the free space, or at least `back_len`, after the buffer. */
+static int _emitter_grow(ABCodecInstance* nc, size_t front_len, size_t back_len)
+{
+    ABEmitter* E = &nc->emitter;
+    size_t     used = E->back - E->front;
+    size_t     need = used + front_len + back_len;
+    size_t capacity = E->capacity ? E->capacity * 2 : AB_EMITTER_MIN_CAPACITY;
+    while (capacity < 2 * need)
+        capacity *= 2;
+
+    uint8_t* block = malloc(capacity);
+    if (block == NULL) return -1;
+    size_t back_room = (capacity - used) / 4;
+    if (back_room < back_len) back_room = back_len;
+    size_t front = capacity - used - back_room;
+    if (used) memcpy(block + front, E->block + E->front, used);
+    free(E->block);
+    E->block = block;
+    E->capacity = capacity;
+    E->front = front;
+    E->back = front + used;
+    nc->stats.alloc_count++;
+    return 0;
+}
+
+
+/* Builder emitter function (flatcc_builder_emit_fun). */
+static int _emitter_emit(void* emit_context, const flatcc_iovec_t* iov,
+    int iov_count, flatbuffers_soffset_t offset, size_t len)
+{
+    ABCodecInstance* nc = emit_context;
+    ABEmitter*       E = &nc->emitter;
+    uint8_t*         p;
+
+    if (offset < 0) {
+        if (len > E->front && _emitter_grow(nc, len, 0)) return -1;
+        E->front -= len;
+        p = E->block + E->front;
+    } else {
+        if (len > E->capacity - E->back && _emitter_grow(nc, 0, len)) {
+            return -1;
+        }
+        p = E->block + E->back;
+        E->back += len;
+    }
+    for (int i = 0; i < iov_count; i++) {
+        memcpy(p, iov[i].iov_base, iov[i].iov_len);
+        p += iov[i].iov_len;
+    }
+    return 0;
+}
+
+
+/* Reset the emitter (empty buffer), the block is retained. Unless builder
+   capacity is retained (builder_retain), the block is halved when the average
+   use falls below a quarter of its capacity, which gradually reduces the peak
+   allocation. */
+static void _emitter_reset(ABCodecInstance* nc)
+{
+    ABEmitter* E = &nc->emitter;
+    size_t     used = E->back - E->front;
+    if (E->used_average == 0) E->used_average = used;
+    E->used_average = E->used_average * 3 / 4 + used / 4;
+    if (nc->builder_retain == false && E->capacity > AB_EMITTER_MIN_CAPACITY &&
+        E->used_average < E->capacity / 4) {
+        uint8_t* block = realloc(E->block, E->capacity / 2);
+        if (block) {
+            E->block = block;
+            E->capacity /= 2;
+        }
+    }
+    E->front = E->back = E->capacity - E->capacity / 4;
+}
+
+
+/* Reserve emitter capacity for a buffer of `size` bytes (builder_reserve).
+   The builder data stack is not reserved, it grows to the size needed by the
+   first step and is then retained. */
+static void _emitter_reserve(ABCodecInstance* nc, size_t size)
+{
+    ABEmitter* E = &nc->emitter;
+    if (E->back == E->front && E->front < size) _emitter_grow(nc, size, 0);
+    if (E->used_average < size) E->used_average = size;
+}
+
+
+/* Reset the builder (and emitter), allocations are retained. */
+DLL_PRIVATE void reset_builder(ABCodecInstance* nc)
+{
+    flatcc_builder_reset(nc->fbs_builder);
+    _emitter_reset(nc);
+    /* String references are only valid within the builder buffer. */
+    if (nc->intern) {
+        nc->intern->count = 0;
+        nc->intern->pool_used = 0;
+    }
+    if (nc->ip_cache && ++nc->ip_cache->generation == 0) {
+        memset(nc->ip_cache, 0, sizeof(ABMetadataCache));
+        nc->ip_cache->generation = 1;
+    }
+}
+
+
+/* Create a string in the current builder buffer, or reference the string
+   created earlier (in the same buffer) with identical content. */
+DLL_PRIVATE flatbuffers_string_ref_t intern_string(
+    ABCodecInstance* nc, const char* str)
+{
+    flatcc_builder_t* B = nc->fbs_builder;
+
+    /* FNV-1a, calculated with the string length. */
+    uint32_t hash = 2166136261u;
+    size_t   len = 0;
+    for (; str[len]; len++) {
+        hash = (hash ^ (uint8_t)str[len]) * 16777619u;
+    }
+
+    ABInternCache* c = nc->intern;
+    if (c == NULL) {
+        c = nc->intern = calloc(1, sizeof(ABInternCache));
+        if (c == NULL) return flatbuffers_string_create(B, str, len);
+    }
+    for (size_t i = 0; i < c->count; i++) {
+        ABInternEntry* e = &c->entry[i];
+        if (e->hash == hash && e->len == len &&
+            memcmp(c->pool + e->offset, str, len) == 0) {
+            return e->ref;
+        }
+    }
+
+    flatbuffers_string_ref_t ref = flatbuffers_string_create(B, str, len);
+    if (ref && c->count < AB_INTERN_SIZE &&
+        len <= AB_INTERN_POOL - c->pool_used) {
+        memcpy(c->pool + c->pool_used, str, len);
+        c->entry[c->count++] = (ABInternEntry){
+            .hash = hash,
+            .offset = c->pool_used,
+            .len = len,
+            .ref = ref,
+        };
+        c->pool_used += len;
+    }
+    return ref;
+}
+
+
+/* Builder allocator, counts allocations (i.e. buffer growth) and then calls
+   the configured allocator. */
+static int _builder_alloc(void* alloc_context, flatcc_iovec_t* b,
+    size_t request, int zero_fill, int alloc_type)
+{
+    ABCodecInstance* nc = alloc_context;
+    if (request > b->iov_len) nc->stats.alloc_count++;
+    return nc->alloc(nc->alloc_context, b, request, zero_fill, alloc_type);
+}
+
+
+/* (Re)initialise the builder with the configured allocator (called via
+   _builder_alloc). */
+static int32_t _builder_init(ABCodecInstance* _nc)
+{
+    flatcc_builder_t* B = _nc->fbs_builder;
+
+    if (B) {
+        flatcc_builder_clear(B);
+    } else {
+        B = malloc(sizeof(flatcc_builder_t));
+        if (B == NULL) return -ENOMEM;
+        _nc->fbs_builder = B;
+    }
+    arena_destroy(&_nc->arena);
+    _nc->emitter.front = _nc->emitter.back =
+        _nc->emitter.capacity - _nc->emitter.capacity / 4;
+    free(_nc->intern);
+    _nc->intern = NULL;
+    free(_nc->ip_cache);
+    _nc->ip_cache = NULL;
+    if (_nc->fbs_alloc) {
+        _nc->alloc = _nc->fbs_alloc;
+        _nc->alloc_context = _nc->fbs_alloc_context;
+    } else if (_nc->arena.chunk_size) {
+        _nc->alloc = arena_alloc;
+        _nc->alloc_context = &_nc->arena;
+    } else {
+        _nc->alloc = flatcc_builder_default_alloc;
+        _nc->alloc_context = NULL;
+    }
+    flatcc_builder_custom_init(B, _emitter_emit, _nc, _builder_alloc, _nc);
+    B->buffer_flags |= flatcc_builder_with_size;
+    if (_nc->builder_reserve) _emitter_reserve(_nc, _nc->builder_reserve);
+    _nc->fbs_stream_initalized = false;
+    return 0;
+}
+
+
+/* Get the builder, which is initialised on first use (i.e. the first write),
+   codec instances which only read do not allocate a builder. */
+DLL_PRIVATE flatcc_builder_t* get_builder(ABCodecInstance* nc)
+{
+    if (nc->fbs_builder == NULL && _builder_init(nc) < 0) return NULL;
+    return nc->fbs_builder;
+}
+
+
+static int _filter_range_compare(const void* a, const void* b)
+{
+    const ABFilterRange* _a = a;
+    const ABFilterRange* _b = b;
+    if (_a->first < _b->first) return -1;
+    if (_a->first > _b->first) return 1;
+    return 0;
+}
+
+
+static void _filter_free(ABFilter* filter)
+{
+    if (filter == NULL) return;
+
+    free(filter->ranges);
+    free(filter->masks);
+    free(filter);
+}
+
+
+DLL_PRIVATE bool filter_match(const ABFilter* filter, uint32_t id)
+{
+    /* Ranges: search for the last range starting at or before id. */
+    size_t lo = 0;
+    size_t hi = filter->range_count;
+    while (lo < hi) {
+        size_t mid = lo + (hi - lo) / 2;
+        if (filter->ranges[mid].first <= id) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    if (lo && id <= filter->ranges[lo - 1].last) return true;
+
+    /* Masks. */
+    for (size_t i = 0; i < filter->mask_count; i++) {
+        const ABFilterMask* m = &filter->masks[i];
+        if ((id & m->mask) == (m->id & m->mask)) return true;
+    }
+    return false;
+}
+
+
+/* Parse an (unsigned) 32 bit filter value, returns the end of the value or
+   NULL if the value is not valid. */
+static char* _filter_value(char* s, uint32_t* value)
+{
+    char* e;
+    if (*s == '-' || *s == '+') return NULL;
+    errno = 0;
+    unsigned long long v = strtoull(s, &e, 0);
+    if (e == s || errno == ERANGE || v > UINT32_MAX) return NULL;
+    *value = (uint32_t)v;
+    return e;
+}
+
+
+/* Filter specification: a list of IDs (`id`), ranges (`first-last`) and
+   masks (`id/mask`), separated by `,` and/or ` `. An empty specification
+   removes the filter. */
+static int32_t _filter_config(ABCodecInstance* _nc, const char* spec)
+{
+    /* Each separator may delimit a token. */
+    size_t count = 1;
+    for (const char* p = spec; *p; p++) {
+        if (*p == ',' || *p == ' ') count++;
+    }
+    ABFilterRange* ranges = calloc(count, sizeof(ABFilterRange));
+    ABFilterMask*  masks = calloc(count, sizeof(ABFilterMask));
+    char*          _buf = strdup(spec);
+    size_t         range_count = 0;
+    size_t         mask_count = 0;
+    int32_t        rc = -ENOMEM;
+    if (ranges == NULL || masks == NULL || _buf == NULL) goto config_fail;
+
+    rc = -EINVAL;
+    char* _pos = NULL;
+    for (char* t = strtok_r(_buf, ", ", &_pos); t;
+         t = strtok_r(NULL, ", ", &_pos)) {
+        uint32_t id;
+        char*    e = _filter_value(t, &id);
+        if (e == NULL) goto config_fail;
+        if (*e == '\0') {
+            ranges[range_count++] = (ABFilterRange){ id, id };
+        } else if (*e == '-' || *e == '/') {
+            char*    v = e + 1;
+            uint32_t value;
+            e = _filter_value(v, &value);
+            if (e == NULL || *e != '\0') goto config_fail;
+            if (*(v - 1) == '-') {
+                ranges[range_count++] = (ABFilterRange){ id, value };
+            } else {
+                masks[mask_count++] = (ABFilterMask){ id, value };
+            }
+        } else {
+            goto config_fail;
+        }
+    }
+    rc = ab_codec_set_filter(
+        (NCODEC*)_nc, ranges, range_count, masks, mask_count);
+
+config_fail:
+    free(ranges);
+    free(masks);
+    free(_buf);
+    return rc;
+}
+
+
+static inline size_t _size_prefix(const uint8_t* ptr)
+{
+    size_t len = 0;
+    flatbuffers_read_size_prefix((void*)ptr, &len);
+    return len;
+}
+
+
+/* Index the size prefixed messages of a stream region (one pass), and link
+   each entry to the next entry with a matching identifier. */
+static int32_t _index_build(ABMessageIndex* idx, const uint8_t* buffer,
+    size_t length, const char* identifier)
+{
+    idx->count = 0;
+    idx->cursor = 0;
+    idx->base = buffer;
+    idx->length = length;
+    idx->generation++;
+
+    size_t offset = 0;
+    while (length - offset > 4) {
+        size_t msg_len = _size_prefix(buffer + offset);
+        if (msg_len == 0 || msg_len > length - offset - 4) break;
+        if (idx->count == idx->capacity) {
+            size_t capacity =
+                idx->capacity ? idx->capacity * 2 : INDEX_MIN_CAPACITY;
+            ABMessageEntry* entries =
+                realloc(idx->entries, capacity * sizeof(ABMessageEntry));
+            if (entries == NULL) {
+                idx->count = 0;
+                idx->base = NULL;
+                return -ENOMEM;
+            }
+            idx->entries = entries;
+            idx->capacity = capacity;
+        }
+        idx->entries[idx->count++] = (ABMessageEntry){
+            .offset = offset,
+            .len = msg_len,
+        };
+        offset += msg_len + 4;
+    }
+    uint32_t match = idx->count;
+    for (size_t i = idx->count; i-- > 0;) {
+        ABMessageEntry* e = &idx->entries[i];
+        if (e->len >= 8 && flatbuffers_has_identifier(
+                               buffer + e->offset + 4, identifier)) {
+            match = i;
+        }
+        e->match = match;
+    }
+    return 0;
+}
+
+
+/* Locate the entry at the start of a stream region (i.e. the read position),
+   if the region is indexed. */
+static size_t _index_find(
+    ABMessageIndex* idx, const uint8_t* buffer, size_t length)
+{
+    if (idx->base == NULL || buffer < idx->base) return INDEX_NOT_FOUND;
+    if (buffer + length != idx->base + idx->length) return INDEX_NOT_FOUND;
+
+    size_t offset = buffer - idx->base;
+    if (idx->cursor < idx->count && idx->entries[idx->cursor].offset == offset) {
+        return idx->cursor;
+    }
+    size_t lo = 0;
+    size_t hi = idx->count;
+    while (lo < hi) {
+        size_t mid = lo + (hi - lo) / 2;
+        if (idx->entries[mid].offset < offset) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    if (lo < idx->count && idx->entries[lo].offset == offset) return lo;
+    return INDEX_NOT_FOUND;
+}
+
+
+DLL_PRIVATE void index_reset(ABCodecInstance* nc)
+{
+    nc->msg_index.count = 0;
+    nc->msg_index.cursor = 0;
+    nc->msg_index.base = NULL;
+    nc->msg_index.length = 0;
+    nc->msg_index.generation++;
+}
+
+
+/* Get the next message (with `identifier`) from the stream, and advance the
+   stream position past that message. Messages of the stream are indexed on
+   the first read, subsequent reads (and re-reads) use the index. The stream
+   content may be returned in several regions (e.g. ring buffer), each region
+   is indexed separately. */
+DLL_PRIVATE uint8_t* index_next_message(
+    ABCodecInstance* nc, const char* identifier, size_t* msg_len)
+{
+    ABMessageIndex* idx = &nc->msg_index;
+
+    while (1) {
+        uint8_t* buffer;
+        size_t   length;
+        nc->c.stream->read((NCODEC*)nc, &buffer, &length, NCODEC_POS_NC);
+        if (buffer == NULL || length == 0) break;
+
+        /* Locate the entry at the read position, or index the region. */
+        size_t i = _index_find(idx, buffer, length);
+        if (i == INDEX_NOT_FOUND) {
+            if (_index_build(idx, buffer, length, identifier) < 0) break;
+            i = 0;
+        }
+        if (idx->count == 0) break;
+
+        /* Next matching entry (foreign messages are skipped), the content of
+           the region may have changed (i.e. without a truncate). */
+        size_t                j = idx->entries[i].match;
+        const ABMessageEntry* e =
+            &idx->entries[j < idx->count ? j : idx->count - 1];
+        if (_size_prefix(idx->base + e->offset) != e->len) {
+            index_reset(nc);
+            continue;
+        }
+        nc->c.stream->seek((NCODEC*)nc,
+            e->offset + 4 + e->len - idx->entries[i].offset, NCODEC_SEEK_CUR);
+        if (j < idx->count) {
+            idx->cursor = j + 1;
+            *msg_len = e->len;
+            return (uint8_t*)idx->base + e->offset + 4;
+        }
+        /* No matching message in this region, continue with the next. */
+        idx->cursor = idx->count;
+    }
+
+    /* No message in stream. */
+    nc->c.stream->seek((NCODEC*)nc, 0, NCODEC_SEEK_END);
+    return NULL;
+}
+
+
 void free_codec(ABCodecInstance* _nc)
 {
     if (_nc == NULL) return;
@@ -54,7 +645,19 @@ void free_codec(ABCodecInstance* _nc)
     if (_nc->interface_id_str) free(_nc->interface_id_str);
     if (_nc->swc_id_str) free(_nc->swc_id_str);
     if (_nc->ecu_id_str) free(_nc->ecu_id_str);
-    if (_nc->fbs_builder_initalized) flatcc_builder_clear(&_nc->fbs_builder);
+    if (_nc->fbs_builder) {
+        flatcc_builder_clear(_nc->fbs_builder);
+        free(_nc->fbs_builder);
+    }
+    arena_destroy(&_nc->arena);
+    _filter_free(_nc->filter);
+    free(_nc->msg_index.entries);
+    free(_nc->decode_pending.entries);
+    free(_nc->emitter.block);
+    free(_nc->stats_str);
+    free(_nc->intern);
+    free(_nc->ip_cache);
+    free(_nc->decode_cache);
 }
 
 
@@ -116,11 +719,71 @@ int32_t codec_config(NCODEC* nc, NCodecConfigItem item)
         _nc->ecu_id = strtoul(item.value, NULL, 10);
         return 0;
     }
+    if (strcmp(item.name, "arena") == 0) {
+        /* Arena chunk size (0 selects the default allocator). */
+        if (_nc->fbs_stream_initalized) return -EBUSY;
+        _nc->arena.chunk_size = strtoul(item.value, NULL, 10);
+        if (_nc->fbs_builder) return _builder_init(_nc);
+        return 0;
+    }
+    if (strcmp(item.name, "builder_reserve") == 0) {
+        if (_nc->fbs_stream_initalized) return -EBUSY;
+        _nc->builder_reserve = strtoul(item.value, NULL, 10);
+        /* Capacity is reserved now, rather than on first write. */
+        if (_nc->fbs_builder || _nc->builder_reserve) {
+            return _builder_init(_nc);
+        }
+        return 0;
+    }
+    if (strcmp(item.name, "builder_retain") == 0) {
+        _nc->builder_retain = strtoul(item.value, NULL, 10) != 0;
+        return 0;
+    }
+    if (strcmp(item.name, "sender_index") == 0) {
+        _nc->sender_index = strtoul(item.value, NULL, 10) != 0;
+        return 0;
+    }
+    if (strcmp(item.name, "filter") == 0) {
+        return _filter_config(_nc, item.value);
+    }
+    if (strcmp(item.name, "metadata_cache") == 0) {
+        _nc->metadata_cache = strtoul(item.value, NULL, 10) != 0;
+        return 0;
+    }
+    if (strcmp(item.name, "decode") == 0) {
+        if (strcmp(item.value, "lazy") == 0) {
+            _nc->decode_lazy = true;
+        } else if (strcmp(item.value, "eager") == 0) {
+            _nc->decode_lazy = false;
+        } else {
+            return -EINVAL;
+        }
+        return 0;
+    }
 
     return -EINVAL;
 }
 
 
+static const struct {
+    const char* name;
+    size_t      offset;
+} __stats[] = {
+    { "msg_written", offsetof(ABCodecStats, msg_written) },
+    { "msg_read", offsetof(ABCodecStats, msg_read) },
+    { "payload_written", offsetof(ABCodecStats, payload_written) },
+    { "payload_read", offsetof(ABCodecStats, payload_read) },
+    { "encoded_bytes", offsetof(ABCodecStats, encoded_bytes) },
+    { "msg_filtered", offsetof(ABCodecStats, msg_filtered) },
+    { "flush_count", offsetof(ABCodecStats, flush_count) },
+    { "max_buffer", offsetof(ABCodecStats, max_buffer) },
+    { "alloc_count", offsetof(ABCodecStats, alloc_count) },
+    { "msg_rejected", offsetof(ABCodecStats, msg_rejected) },
+};
+_Static_assert(ARRAY_SIZE(__stats) == AB_CODEC_STATS_COUNT,
+    "__stats must list each ABCodecStats counter");
+
+
 NCodecConfigItem codec_stat(NCODEC* nc, int32_t* index)
 {
     ABCodecInstance* _nc = (ABCodecInstance*)nc;
@@ -168,6 +831,23 @@ NCodecConfigItem codec_stat(NCODEC* nc, int32_t* index)
         value = _nc->ecu_id_str;
         break;
     default:
+        if ((size_t)(*index - 9) < ARRAY_SIZE(__stats)) {
+            /* Statistics, each counter has its own value string which is
+               valid until the next call for the same index. */
+            size_t          i = *index - 9;
+            const uint64_t* counter =
+                (const uint64_t*)((uint8_t*)&_nc->stats + __stats[i].offset);
+            name = __stats[i].name;
+            if (_nc->stats_str == NULL) {
+                _nc->stats_str =
+                    calloc(AB_CODEC_STATS_COUNT, sizeof(*_nc->stats_str));
+                if (_nc->stats_str == NULL) break;
+            }
+            snprintf(_nc->stats_str[i], sizeof(_nc->stats_str[i]), "%llu",
+                (unsigned long long)*counter);
+            value = _nc->stats_str[i];
+            break;
+        }
         *index = -1;
     }
 
@@ -187,6 +867,239 @@ void codec_close(NCODEC* nc)
 }
 
 
+/* Write data to the stream, a short write is an error. */
+static int32_t _stream_write(NCODEC* nc, uint8_t* data, size_t len)
+{
+    NCodecStreamVTable* s = ((NCodecInstance*)nc)->stream;
+    size_t              rc = s->write(nc, data, len);
+    if (rc == len) return 0;
+    if ((int64_t)rc < 0) return (int32_t)rc;
+    return -EIO;
+}
+
+
+/* Write the (finalized) builder buffer, held contiguously by the emitter, to
+   the stream. When the stream extension (reserve/commit) was set by the
+   integrator the buffer is copied directly into stream memory, otherwise the
+   buffer is written with a single call to the stream write method (message
+   based streams, i.e. ring and shm, publish each write as a message).
+   If a write fails the error is returned; the streams of this library write
+   all or nothing, and a failed reservation is abandoned (not committed), so
+   no partial buffer is published. The stream is not rolled back (seek/tell
+   are reader positions on most streams). */
+DLL_PRIVATE int32_t emit_stream(ABCodecInstance* nc)
+{
+    NCODEC*                _nc = (NCODEC*)nc;
+    NCodecStreamExtVTable* x = nc->c.stream_ext;
+    uint8_t*               buffer = nc->emitter.block + nc->emitter.front;
+    size_t                 length = nc->emitter.back - nc->emitter.front;
+    int32_t                rc = 0;
+    if (length == 0) return 0;
+
+    if (x && x->size >= sizeof(*x) && x->reserve && x->commit) {
+        uint8_t* data = NULL;
+        rc = x->reserve(_nc, length, &data);
+        if (rc < 0) return rc;
+        memcpy(data, buffer, length);
+        rc = x->commit(_nc, length);
+        if (rc < 0) return rc;
+    } else {
+        rc = _stream_write(_nc, buffer, length);
+        if (rc < 0) return rc;
+    }
+    nc->stats.encoded_bytes += length;
+    if (length > nc->stats.max_buffer) nc->stats.max_buffer = length;
+    return length;
+}
+
+
+/**
+ab_codec_set_allocator
+======================
+
+Set the allocator used by the flatcc builder of an AB Codec instance. The
+allocator is called to grow (and release) the internal buffers of the
+builder, which are retained across steps. Alternatively the built-in arena
+allocator can be selected with the MIMEtype parameter `arena=<chunk size>`.
+
+Parameters
+----------
+nc (NCODEC*)
+: Network Codec object (AB Codec).
+
+alloc (flatcc_builder_alloc_fun*)
+: The allocator function, NULL selects the default allocator.
+
+alloc_context (void*)
+: The allocator context, passed to each call of the allocator function.
+
+Returns
+-------
+0
+: The allocator was set.
+
+-ENOSTR
+: The object represented by `nc` does not represent a valid stream.
+
+-EBUSY
+: The builder contains content (call `ncodec_flush()` or `ncodec_truncate()`
+  first).
+*/
+int32_t ab_codec_set_allocator(
+    NCODEC* nc, flatcc_builder_alloc_fun* alloc, void* alloc_context)
+{
+    ABCodecInstance* _nc = (ABCodecInstance*)nc;
+    if (_nc == NULL) return -ENOSTR;
+    if (_nc->fbs_stream_initalized) return -EBUSY;
+
+    _nc->fbs_alloc = alloc;
+    _nc->fbs_alloc_context = alloc_context;
+    if (_nc->fbs_builder) return _builder_init(_nc);
+    return 0;
+}
+
+
+/**
+ab_codec_stats
+==============
+
+Get the statistics (live counters) of an AB Codec instance. The counters
+accumulate from when the codec is opened, or from the previous call with
+`reset` set (i.e. to sample per-step statistics). The counters are also
+available via `ncodec_stat()`.
+
+Parameters
+----------
+nc (NCODEC*)
+: Network Codec object (AB Codec).
+
+stats (ABCodecStats*)
+: Pointer to an object which receives the statistics, may be NULL.
+
+reset (bool)
+: Reset the counters (after they are copied to `stats`).
+
+Returns
+-------
+0
+: The statistics were returned.
+
+-ENOSTR
+: The object represented by `nc` does not represent a valid stream.
+*/
+int32_t ab_codec_stats(NCODEC* nc, ABCodecStats* stats, bool reset)
+{
+    ABCodecInstance* _nc = (ABCodecInstance*)nc;
+    if (_nc == NULL) return -ENOSTR;
+
+    if (stats) *stats = _nc->stats;
+    if (reset) _nc->stats = (ABCodecStats){ 0 };
+    return 0;
+}
+
+
+/**
+ab_codec_set_filter
+===================
+
+Set the receive filter of an AB Codec instance. Messages (PDUs or CAN frames)
+with an ID which is not accepted by the filter are skipped by `ncodec_read()`
+before they are decoded (and counted as `msg_rejected`). A message ID is
+accepted when it is within one of the ranges, or matches one of the masks.
+The filter can also be set with the MIMEtype parameter
+`filter=<id>,<first>-<last>,<id>/<mask>`.
+
+Parameters
+----------
+nc (NCODEC*)
+: Network Codec object (AB Codec).
+
+ranges (const ABFilterRange*)
+: Accepted ID ranges (inclusive), may be NULL.
+
+range_count (size_t)
+: The number of ranges.
+
+masks (const ABFilterMask*)
+: Accepted ID masks (CAN acceptance filter style), may be NULL.
+
+mask_count (size_t)
+: The number of masks. When both `range_count` and `mask_count` are 0 the
+  filter is removed (all messages are accepted).
+
+Returns
+-------
+0
+: The filter was set.
+
+-ENOSTR
+: The object represented by `nc` does not represent a valid stream.
+
+-EINVAL
+: A range is not valid (i.e. first > last).
+
+-ENOMEM
+: The filter could not be allocated.
+*/
+int32_t ab_codec_set_filter(NCODEC* nc, const ABFilterRange* ranges,
+    size_t range_count, const ABFilterMask* masks, size_t mask_count)
+{
+    ABCodecInstance* _nc = (ABCodecInstance*)nc;
+    if (_nc == NULL) return -ENOSTR;
+    if ((range_count && ranges == NULL) || (mask_count && masks == NULL)) {
+        return -EINVAL;
+    }
+    for (size_t i = 0; i < range_count; i++) {
+        if (ranges[i].first > ranges[i].last) return -EINVAL;
+    }
+
+    ABFilter* filter = NULL;
+    if (range_count || mask_count) {
+        filter = calloc(1, sizeof(ABFilter));
+        if (filter == NULL) return -ENOMEM;
+        filter->ranges = calloc(range_count + 1, sizeof(ABFilterRange));
+        filter->masks = calloc(mask_count + 1, sizeof(ABFilterMask));
+        if (filter->ranges == NULL || filter->masks == NULL) {
+            _filter_free(filter);
+            return -ENOMEM;
+        }
+        /* Sort, and merge overlapping (or adjacent) ranges. */
+        if (range_count) {
+            memcpy(filter->ranges, ranges, range_count * sizeof(ABFilterRange));
+            qsort(filter->ranges, range_count, sizeof(ABFilterRange),
+                _filter_range_compare);
+            size_t n = 0;
+            for (size_t i = 1; i < range_count; i++) {
+                ABFilterRange* r = &filter->ranges[n];
+                if (filter->ranges[i].first <= r->last ||
+                    filter->ranges[i].first - 1 == r->last) {
+                    if (filter->ranges[i].last > r->last) {
+                        r->last = filter->ranges[i].last;
+                    }
+                } else {
+                    filter->ranges[++n] = filter->ranges[i];
+                }
+            }
+            filter->range_count = n + 1;
+        }
+        if (mask_count) {
+            memcpy(filter->masks, masks, mask_count * sizeof(ABFilterMask));
+            filter->mask_count = mask_count;
+        }
+        /* Bitmap, resolving the (more common) lower IDs. */
+        for (uint32_t id = 0; id < AB_FILTER_BITMAP_BITS; id++) {
+            if (filter_match(filter, id)) {
+                filter->bitmap[id >> 3] |= (1 << (id & 7));
+            }
+        }
+    }
+
+    _filter_free(_nc->filter);
+    _nc->filter = filter;
+    return 0;
+}
+
+
 NCODEC* ncodec_create(const char* mime_type)
 {
     char*            _buf = strdup(mime_type);
@@ -251,6 +1164,10 @@ NCODEC* ncodec_create(const char* mime_type)
             .truncate = can_truncate,
             .close = codec_close,
         };
+        _nc->c.batch = (struct NCodecBatchVTable){
+            .write = can_write_batch,
+            .read = can_read_batch,
+        };
     } else if (strcmp(_nc->type, "pdu") == 0) {
         _nc->c.codec = (struct NCodecVTable){
             .config = codec_config,
@@ -261,16 +1178,16 @@ NCODEC* ncodec_create(const char* mime_type)
             .truncate = pdu_truncate,
             .close = codec_close,
         };
+        _nc->c.batch = (struct NCodecBatchVTable){
+            .write = pdu_write_batch,
+            .read = pdu_read_batch,
+        };
     } else {
         goto create_fail;
     }
 
-    /* Complete the setup of this codec instance. */
-    flatcc_builder_init(&_nc->fbs_builder);
-    _nc->fbs_builder.buffer_flags |= flatcc_builder_with_size;
-    _nc->fbs_stream_initalized = false;
-    _nc->fbs_builder_initalized = true;
-
+    /* Complete the setup of this codec instance (the builder is initialised
+       on first write, or when capacity is reserved). */
     return (void*)_nc;
 
 create_fail:
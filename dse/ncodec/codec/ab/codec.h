@@ -10,6 +10,204 @@
 #include <dse/ncodec/schema/abs/stream/flatbuffers_common_reader.h>
 #include <dse/ncodec/schema/abs/stream/flatbuffers_common_builder.h>
 #include <dse/ncodec/codec.h>
+#include <dse/ncodec/interface/frame.h>
+#include <dse/ncodec/interface/pdu.h>
+
+
+/* Arena (bump) allocator, supporting the flatcc builder. Blocks released by
+   the builder (i.e. when a buffer is moved as it grows) are kept on a free
+   list and reused, chunk memory is released when the arena is destroyed
+   (i.e. when the codec is closed). */
+typedef struct ABArenaChunk {
+    struct ABArenaChunk* next;
+    size_t               size;
+    size_t               used;
+    uint8_t              data[];
+} ABArenaChunk;
+
+typedef struct ABArenaBlock {
+    struct ABArenaBlock* next;
+    size_t               size;
+} ABArenaBlock;
+
+typedef struct ABArena {
+    ABArenaChunk* chunks;
+    ABArenaBlock* free_list;
+    size_t        chunk_size;
+} ABArena;
+
+
+/* Builder emitter, the buffer is emitted into a single (contiguous) block
+   which is retained across steps. Buffer content (emitted at negative
+   offsets) grows down from `front`, vtables (emitted at the end of the
+   buffer) grow up from `back`. */
+#define AB_EMITTER_MIN_CAPACITY 4096
+
+typedef struct ABEmitter {
+    uint8_t* block;
+    size_t   capacity;
+    size_t   front; /* Start of the buffer, in the block. */
+    size_t   back;  /* End of the buffer, in the block. */
+    size_t   used_average;
+} ABEmitter;
+
+
+/* Sender index: Stream.node_uid carries the sender of the stream (node_id or
+   swc_id, at most AB_SENDER_INDEX_MAX) combined with a marker. Streams with a
+   sender which does not fit are not tagged. The marker also identifies the
+   encoding (version 1), a different encoding must use a different marker.
+   Values without the marker (i.e. node UIDs set by other writers) are not
+   interpreted as a sender index, however node UIDs of other writers which
+   match the marker pattern are; such writers should not share a bus with
+   codecs using the sender index. */
+#define AB_SENDER_INDEX_MARKER 0x5E1D0000u
+#define AB_SENDER_INDEX_MAX    0xFFFFu
+#define AB_SENDER_INDEX(id)    (AB_SENDER_INDEX_MARKER | (id))
+
+
+/* Receive filter (allowlist of message IDs), see ab_codec_set_filter().
+   The ranges are sorted and merged, and IDs below AB_FILTER_BITMAP_BITS are
+   resolved with a bitmap (i.e. standard CAN IDs). */
+#define AB_FILTER_BITMAP_BITS 2048
+
+typedef struct ABFilterRange {
+    uint32_t first;
+    uint32_t last;
+} ABFilterRange;
+
+/* Acceptance mask, matches when: (msg_id & mask) == (id & mask). */
+typedef struct ABFilterMask {
+    uint32_t id;
+    uint32_t mask;
+} ABFilterMask;
+
+typedef struct ABFilter {
+    ABFilterRange* ranges;
+    size_t         range_count;
+    ABFilterMask*  masks;
+    size_t         mask_count;
+    uint8_t        bitmap[AB_FILTER_BITMAP_BITS / 8];
+} ABFilter;
+
+
+/* String intern cache (write side), strings emitted in the current stream
+   (i.e. builder buffer) are referenced again rather than emitted again. The
+   content of interned strings is kept in the pool (the caller strings may be
+   released after the write). */
+#define AB_INTERN_SIZE 16
+#define AB_INTERN_POOL 512
+
+typedef struct ABInternEntry {
+    uint32_t                 hash;
+    uint16_t                 offset; /* Content, in the pool. */
+    uint16_t                 len;
+    flatbuffers_string_ref_t ref;
+} ABInternEntry;
+
+typedef struct ABInternCache {
+    ABInternEntry entry[AB_INTERN_SIZE];
+    size_t        count;
+    char          pool[AB_INTERN_POOL];
+    size_t        pool_used;
+} ABInternCache;
+
+
+/* Transport metadata cache (write side, parameter `metadata_cache`), IP
+   message metadata emitted in the current stream is referenced by later PDUs
+   with identical metadata. Direct mapped (on the metadata hash), entries are
+   valid for the stream (generation) in which they were emitted. */
+#define AB_METADATA_CACHE_SIZE 64
+
+typedef struct ABMetadataEntry {
+    uint32_t                   generation;
+    uint32_t                   hash;
+    NCodecPduIpMessageMetadata ip; /* Canonical copy (zero padding). */
+    flatbuffers_ref_t          ref;
+} ABMetadataEntry;
+
+typedef struct ABMetadataCache {
+    ABMetadataEntry entry[AB_METADATA_CACHE_SIZE];
+    uint32_t        generation;
+} ABMetadataCache;
+
+
+/* Decoded metadata cache (read side), IP and struct metadata decoded from a
+   transport table, keyed by the table address. Direct mapped, entries are
+   valid for the message (generation) in which they were decoded. */
+#define AB_DECODE_CACHE_SIZE 16
+
+typedef struct ABDecodeEntry {
+    const void*            table;
+    uint32_t               generation;
+    NCodecPduTransportType type;
+    union {
+        NCodecPduIpMessageMetadata ip_message;
+        NCodecPduStructMetadata    struct_object;
+    } metadata;
+} ABDecodeEntry;
+
+typedef struct ABDecodeCache {
+    ABDecodeEntry entry[AB_DECODE_CACHE_SIZE];
+    /* Incremented for each message parsed from the stream. */
+    uint32_t      generation;
+} ABDecodeCache;
+
+
+/* Lazy decode, PDUs returned by ncodec_read() with pending (encoded) transport
+   metadata, see ab_pdu_transport(). A PDU is identified by its id and payload
+   (which references the stream), or by the PDU object when it has no payload.
+   Entries are valid until the stream is truncated. */
+typedef struct ABLazyEntry {
+    const NCodecPdu* pdu;
+    const uint8_t*   payload;
+    uint32_t         id;
+    const void*      table; /* Pdu table, NULL once decoded. */
+} ABLazyEntry;
+
+typedef struct ABLazyList {
+    ABLazyEntry* entries;
+    size_t       count;
+    size_t       capacity;
+} ABLazyList;
+
+
+/* Message index (read side), the size prefixed messages of a stream region,
+   built with one pass over the region and reused by subsequent reads (and
+   re-reads, i.e. after NCODEC_SEEK_SET). */
+typedef struct ABMessageEntry {
+    size_t   offset; /* Offset of the size prefix, in the region. */
+    uint32_t len;    /* Message length (excluding the size prefix). */
+    uint32_t match;  /* Next entry (this or later) with matching identifier. */
+} ABMessageEntry;
+
+typedef struct ABMessageIndex {
+    ABMessageEntry* entries;
+    size_t          count;
+    size_t          capacity;
+    size_t          cursor;
+    /* Indexed region. */
+    const uint8_t*  base;
+    size_t          length;
+    /* Incremented when a region is indexed, or the index reset. */
+    uint32_t        generation;
+} ABMessageIndex;
+
+
+/* Codec statistics (live counters), see ab_codec_stats(). */
+typedef struct ABCodecStats {
+    uint64_t msg_written;
+    uint64_t msg_read;
+    uint64_t payload_written;
+    uint64_t payload_read;
+    uint64_t encoded_bytes;
+    uint64_t msg_filtered;
+    uint64_t flush_count;
+    uint64_t max_buffer;
+    uint64_t alloc_count;
+    uint64_t msg_rejected;
+} ABCodecStats;
+
+#define AB_CODEC_STATS_COUNT (sizeof(ABCodecStats) / sizeof(uint64_t))
 
 
 /* Declare an extension to the NCodecInstance type. */
@@ -37,13 +235,46 @@ typedef struct ABCodecInstance {
     uint8_t ecu_id;
 
     /* Flatbuffer resources. */
-    flatcc_builder_t fbs_builder;
-    bool             fbs_builder_initalized;
-    bool             fbs_stream_initalized;
+    /* Builder: allocated on first write (read only codecs have none). */
+    flatcc_builder_t* fbs_builder;
+    bool              fbs_stream_initalized;
+    /* Builder allocator: custom (ab_codec_set_allocator), arena or default. */
+    flatcc_builder_alloc_fun* fbs_alloc;
+    void*                     fbs_alloc_context;
+    ABArena                   arena;
+    flatcc_builder_alloc_fun* alloc; /* Selected at builder init. */
+    void*                     alloc_context;
+    /* Builder capacity: reserved at open, retained across resets. */
+    size_t                    builder_reserve;
+    bool                      builder_retain;
+    ABEmitter                 emitter;
+    /* Sender index: streams are tagged with their sender (Stream.node_uid,
+       see AB_SENDER_INDEX) so that readers can skip their own streams. */
+    bool                      sender_index;
+    uint32_t                  stream_sender;
+    bool                      stream_mixed;
+    /* String intern cache (allocated on first use). */
+    ABInternCache*            intern;
+    /* Transport metadata cache (allocated on first use). */
+    bool                      metadata_cache;
+    ABMetadataCache*          ip_cache;
+
+    /* Receive filter (NULL accepts all messages). */
+    ABFilter*      filter;
+    /* Lazy decode: transport metadata is decoded by ab_pdu_transport(). */
+    bool           decode_lazy;
+    ABLazyList     decode_pending;
+    /* Decoded metadata cache (allocated on first use). */
+    ABDecodeCache* decode_cache;
+
+    /* Statistics (supporting ncodec_stat() and ab_codec_stats()). */
+    ABCodecStats stats;
+    char (*stats_str)[24]; /* AB_CODEC_STATS_COUNT, allocated on first use. */
 
     /* Message parsing state. */
-    uint8_t* msg_ptr;
-    size_t   msg_len;
+    uint8_t*       msg_ptr;
+    size_t         msg_len;
+    ABMessageIndex msg_index;
 
     /* Frame parsing state. */
     const flatbuffers_uoffset_t* vector;
@@ -52,4 +283,57 @@ typedef struct ABCodecInstance {
 } ABCodecInstance;
 
 
+/* Internal interface (shared by codec implementations). */
+DLL_PRIVATE int32_t  emit_stream(ABCodecInstance* nc);
+DLL_PRIVATE void     reset_builder(ABCodecInstance* nc);
+DLL_PRIVATE int      arena_alloc(void* alloc_context, flatcc_iovec_t* b,
+         size_t request, int zero_fill, int alloc_type);
+DLL_PRIVATE void     arena_destroy(ABArena* arena);
+DLL_PRIVATE bool     filter_match(const ABFilter* filter, uint32_t id);
+DLL_PRIVATE uint8_t* index_next_message(
+    ABCodecInstance* nc, const char* identifier, size_t* msg_len);
+DLL_PRIVATE void     index_reset(ABCodecInstance* nc);
+
+DLL_PRIVATE flatcc_builder_t*        get_builder(ABCodecInstance* nc);
+DLL_PRIVATE flatbuffers_string_ref_t intern_string(
+    ABCodecInstance* nc, const char* str);
+
+/* Receive filter, evaluated before a message is decoded. */
+static inline bool filter_accept(const ABFilter* filter, uint32_t id)
+{
+    if (filter == NULL) return true;
+    if (id < AB_FILTER_BITMAP_BITS) {
+        return filter->bitmap[id >> 3] & (1 << (id & 7));
+    }
+    return filter_match(filter, id);
+}
+
+
+/* AB Codec API. */
+DLL_PUBLIC int32_t ab_codec_set_allocator(
+    NCODEC* nc, flatcc_builder_alloc_fun* alloc, void* alloc_context);
+DLL_PUBLIC int32_t ab_codec_stats(
+    NCODEC* nc, ABCodecStats* stats, bool reset);
+DLL_PUBLIC int32_t ab_codec_set_filter(NCODEC* nc, const ABFilterRange* ranges,
+    size_t range_count, const ABFilterMask* masks, size_t mask_count);
+
+/* AB Codec API, static dispatch (statically linked codec). */
+DLL_PUBLIC int32_t ab_pdu_write(NCODEC* nc, NCodecPdu* pdu);
+DLL_PUBLIC int32_t ab_pdu_read(NCODEC* nc, NCodecPdu* pdu);
+DLL_PUBLIC int32_t ab_pdu_write_batch(
+    NCODEC* nc, NCodecPdu* pdus, size_t count);
+DLL_PUBLIC int32_t ab_pdu_read_batch(NCODEC* nc, NCodecPdu* pdus, size_t count);
+DLL_PUBLIC int32_t ab_pdu_flush(NCODEC* nc);
+DLL_PUBLIC int32_t ab_pdu_truncate(NCODEC* nc);
+DLL_PUBLIC int32_t ab_pdu_transport(NCODEC* nc, NCodecPdu* pdu);
+DLL_PUBLIC int32_t ab_can_write(NCODEC* nc, NCodecCanMessage* msg);
+DLL_PUBLIC int32_t ab_can_read(NCODEC* nc, NCodecCanMessage* msg);
+DLL_PUBLIC int32_t ab_can_write_batch(
+    NCODEC* nc, NCodecCanMessage* msgs, size_t count);
+DLL_PUBLIC int32_t ab_can_read_batch(
+    NCODEC* nc, NCodecCanMessage* msgs, size_t count);
+DLL_PUBLIC int32_t ab_can_flush(NCODEC* nc);
+DLL_PUBLIC int32_t ab_can_truncate(NCODEC* nc);
+
+
 #endif  // DSE_NCODEC_CODEC_AB_CODEC_H_
@@ -15,15 +15,17 @@
 #define ns(x) FLATBUFFERS_WRAP_NAMESPACE(AutomotiveBus_Stream_Frame, x)
 
 
-static void initialize_stream(ABCodecInstance* nc)
+static int32_t initialize_stream(ABCodecInstance* nc)
 {
-    if (nc->fbs_stream_initalized) return;
+    if (nc->fbs_stream_initalized) return 0;
 
-    flatcc_builder_t* B = &nc->fbs_builder;
-    flatcc_builder_reset(B);
+    /* The builder is initialised on first use (and reset after each stream). */
+    flatcc_builder_t* B = get_builder(nc);
+    if (B == NULL) return -ENOMEM;
     ns(Stream_start_as_root_with_size(B));
     ns(Stream_frames_start(B));
     nc->fbs_stream_initalized = true;
+    return 0;
 }
 
 
@@ -31,40 +33,32 @@ static void reset_stream(ABCodecInstance* nc)
 {
     if (nc->fbs_stream_initalized == false) return;
 
-    flatcc_builder_t* B = &nc->fbs_builder;
-    flatcc_builder_reset(B);
+    reset_builder(nc);
     nc->fbs_stream_initalized = false;
 }
 
 
-static void finalize_stream(
-    ABCodecInstance* nc, uint8_t** buffer, size_t* length)
+static int32_t finalize_stream(ABCodecInstance* nc)
 {
-    if (nc->fbs_stream_initalized == false) {
-        *buffer = NULL;
-        *length = 0;
-        return;
-    }
+    if (nc->fbs_stream_initalized == false) return 0;
 
-    flatcc_builder_t* B = &nc->fbs_builder;
+    flatcc_builder_t* B = nc->fbs_builder;
     ns(Stream_frames_end(B));
+    /* Sender index: all frames are sent with the node_id of this codec. */
+    if (nc->sender_index && nc->node_id) {
+        ns(Stream_node_uid_add(B, AB_SENDER_INDEX(nc->node_id)));
+    }
     ns(Stream_end_as_root(B));
-    *buffer = flatcc_builder_finalize_buffer(B, length);
+    int32_t rc = emit_stream(nc);
     reset_stream(nc);
+    return rc;
 }
 
 
-int32_t can_write(NCODEC* nc, NCodecMessage* msg)
+static int32_t _encode_can_frame(ABCodecInstance* _nc, NCodecCanMessage* _msg)
 {
-    ABCodecInstance*  _nc = (ABCodecInstance*)nc;
-    NCodecCanMessage* _msg = (NCodecCanMessage*)msg;
-    if (_nc == NULL) return -ENOSTR;
-    if (_msg == NULL) return -EINVAL;
-    if (_nc->c.stream == NULL) return -ENOSR;
+    flatcc_builder_t* B = _nc->fbs_builder;
 
-    flatcc_builder_t* B = &_nc->fbs_builder;
-
-    initialize_stream(_nc);
     ns(Stream_frames_push_start(B));
     ns(CanFrame_start(B));
     /* Encode the message. */
@@ -80,10 +74,50 @@ int32_t can_write(NCODEC* nc, NCodecMessage* msg)
     ns(Frame_f_CanFrame_add(B, ns(CanFrame_end(B))));
     ns(Stream_frames_push_end(B));
 
+    _nc->stats.msg_written++;
+    _nc->stats.payload_written += _msg->len;
     return _msg->len;
 }
 
 
+int32_t can_write(NCODEC* nc, NCodecMessage* msg)
+{
+    ABCodecInstance*  _nc = (ABCodecInstance*)nc;
+    NCodecCanMessage* _msg = (NCodecCanMessage*)msg;
+    if (_nc == NULL) return -ENOSTR;
+    if (_msg == NULL) return -EINVAL;
+    if (_nc->c.stream == NULL) return -ENOSR;
+
+    int32_t rc = initialize_stream(_nc);
+    if (rc < 0) return rc;
+    return _encode_can_frame(_nc, _msg);
+}
+
+
+int32_t can_write_batch(
+    NCODEC* nc, NCodecMessage* msgs, size_t count, size_t size)
+{
+    ABCodecInstance* _nc = (ABCodecInstance*)nc;
+    if (_nc == NULL) return -ENOSTR;
+    if (msgs == NULL || size < sizeof(NCodecCanMessage)) return -EINVAL;
+    if (_nc->c.stream == NULL) return -ENOSR;
+
+    if (count > INT32_MAX) count = INT32_MAX;
+
+    int32_t rc = initialize_stream(_nc);
+    if (rc < 0) return rc;
+    size_t i;
+    for (i = 0; i < count; i++) {
+        NCodecCanMessage* _msg =
+            (NCodecCanMessage*)((uint8_t*)msgs + i * size);
+        rc = _encode_can_frame(_nc, _msg);
+        /* Stop at the first failed message. */
+        if (rc < 0) return i ? (int32_t)i : rc;
+    }
+    return i;
+}
+
+
 static void get_msg_from_stream(NCODEC* nc)
 {
     ABCodecInstance* _nc = (ABCodecInstance*)nc;
@@ -95,32 +129,14 @@ static void get_msg_from_stream(NCODEC* nc)
     _nc->vector_idx = 0;
     _nc->vector_len = 0;
 
-    /* Next message? */
-    uint8_t* buffer;
-    size_t   length;
-    _nc->c.stream->read(nc, &buffer, &length, NCODEC_POS_NC);
-
-    uint8_t*       msg_ptr = buffer;
-    uint8_t* const buffer_ptr = buffer;
-    while ((size_t)(msg_ptr - buffer_ptr) < length) {
-        /* Messages start with a size prefix. */
-        size_t msg_len = 0;
-        msg_ptr = flatbuffers_read_size_prefix(msg_ptr, &msg_len);
-        if (msg_len == 0) break;
-        /* Advance the stream pos (+4 for size prefix). */
-        _nc->c.stream->seek(nc, msg_len + 4, NCODEC_SEEK_CUR);
-        /* Set the parsing state. */
-        if (flatbuffers_has_identifier(msg_ptr, flatbuffers_identifier)) {
-            _nc->msg_ptr = msg_ptr;
-            _nc->msg_len = msg_len;
-            return;
-        }
-        /* Next message in the stream. */
-        msg_ptr += msg_len;
+    /* Next message (from the message index of the stream). */
+    size_t   msg_len = 0;
+    uint8_t* msg_ptr =
+        index_next_message(_nc, flatbuffers_identifier, &msg_len);
+    if (msg_ptr) {
+        _nc->msg_ptr = msg_ptr;
+        _nc->msg_len = msg_len;
     }
-
-    /* No message in stream. */
-    _nc->c.stream->seek(nc, 0, NCODEC_SEEK_END);
 }
 
 static void get_vector_from_message(NCODEC* nc)
@@ -139,16 +155,25 @@ static void get_vector_from_message(NCODEC* nc)
     ns(Stream_table_t) stream = ns(Stream_as_root(_nc->msg_ptr));
     _nc->vector = ns(Stream_frames(stream));
     _nc->vector_len = ns(Frame_vec_len(_nc->vector));
+
+    /* Sender index: skip streams sent by this codec (sender==receiver). */
+    if (_nc->sender_index && _nc->node_id &&
+        ns(Stream_node_uid(stream)) == AB_SENDER_INDEX(_nc->node_id)) {
+        for (uint32_t i = 0; i < _nc->vector_len; i++) {
+            ns(Frame_table_t) frame = ns(Frame_vec_at(_nc->vector, i));
+            if (ns(Frame_f_is_present(frame)) &&
+                ns(Frame_f_type(frame)) == ns(FrameTypes_CanFrame)) {
+                _nc->stats.msg_filtered++;
+            }
+        }
+        _nc->vector_idx = _nc->vector_len;
+    }
 }
 
 
-int32_t can_read(NCODEC* nc, NCodecMessage* msg)
+static int32_t _decode_can_frame(ABCodecInstance* _nc, NCodecCanMessage* _msg)
 {
-    ABCodecInstance*  _nc = (ABCodecInstance*)nc;
-    NCodecCanMessage* _msg = (NCodecCanMessage*)msg;
-    if (_nc == NULL) return -ENOSTR;
-    if (_msg == NULL) return -EINVAL;
-    if (_nc->c.stream == NULL) return -ENOSR;
+    NCODEC* nc = (NCODEC*)_nc;
 
     /* Reset the message, in case caller ignores the return value. */
     _msg->len = 0;
@@ -169,11 +194,20 @@ int32_t can_read(NCODEC* nc, NCodecMessage* msg)
             ns(CanFrame_table_t) can_frame =
                 (ns(CanFrame_table_t))ns(Frame_f(frame));
             if ((_nc->node_id) &&
-                (_nc->node_id == ns(CanFrame_node_id(can_frame))))
+                (_nc->node_id == ns(CanFrame_node_id(can_frame)))) {
+                _nc->stats.msg_filtered++;
                 continue;
+            }
+
+            /* Filter: receive filter (before the message is decoded). */
+            uint32_t frame_id = ns(CanFrame_frame_id(can_frame));
+            if (!filter_accept(_nc->filter, frame_id)) {
+                _nc->stats.msg_rejected++;
+                continue;
+            }
 
             /* Return the message. */
-            _msg->frame_id = ns(CanFrame_frame_id(can_frame));
+            _msg->frame_id = frame_id;
             _msg->frame_type = ns(CanFrame_frame_type(can_frame));
             flatbuffers_uint8_vec_t payload = ns(CanFrame_payload(can_frame));
             _msg->buffer =
@@ -186,6 +220,8 @@ int32_t can_read(NCODEC* nc, NCodecMessage* msg)
 
             /* ... but don't forget to save the vector index either. */
             _nc->vector_idx = _vi + 1;
+            _nc->stats.msg_read++;
+            _nc->stats.payload_read += _msg->len;
             return _msg->len;
         }
 
@@ -199,21 +235,47 @@ int32_t can_read(NCODEC* nc, NCodecMessage* msg)
 }
 
 
-int32_t can_flush(NCODEC* nc)
+int32_t can_read(NCODEC* nc, NCodecMessage* msg)
+{
+    ABCodecInstance*  _nc = (ABCodecInstance*)nc;
+    NCodecCanMessage* _msg = (NCodecCanMessage*)msg;
+    if (_nc == NULL) return -ENOSTR;
+    if (_msg == NULL) return -EINVAL;
+    if (_nc->c.stream == NULL) return -ENOSR;
+
+    return _decode_can_frame(_nc, _msg);
+}
+
+
+int32_t can_read_batch(
+    NCODEC* nc, NCodecMessage* msgs, size_t count, size_t size)
 {
     ABCodecInstance* _nc = (ABCodecInstance*)nc;
     if (_nc == NULL) return -ENOSTR;
+    if (msgs == NULL || size < sizeof(NCodecCanMessage)) return -EINVAL;
     if (_nc->c.stream == NULL) return -ENOSR;
 
-    uint8_t* buffer = NULL;
-    size_t   length = 0;
+    if (count > INT32_MAX) count = INT32_MAX;
 
-    finalize_stream(_nc, &buffer, &length);
-    if (buffer) {
-        _nc->c.stream->write(nc, buffer, length);
-        free(buffer);
+    size_t i;
+    for (i = 0; i < count; i++) {
+        NCodecCanMessage* _msg =
+            (NCodecCanMessage*)((uint8_t*)msgs + i * size);
+        if (_decode_can_frame(_nc, _msg) < 0) break;
     }
-    return length;
+    if (i == 0 && count) return -ENOMSG;
+    return i;
+}
+
+
+int32_t can_flush(NCODEC* nc)
+{
+    ABCodecInstance* _nc = (ABCodecInstance*)nc;
+    if (_nc == NULL) return -ENOSTR;
+    if (_nc->c.stream == NULL) return -ENOSR;
+
+    _nc->stats.flush_count++;
+    return finalize_stream(_nc);
 }
 
 
@@ -225,6 +287,83 @@ int32_t can_truncate(NCODEC* nc)
 
     reset_stream(_nc);
     _nc->c.stream->seek(nc, 0, NCODEC_SEEK_RESET);
+    index_reset(_nc);
+    /* Reset the message parsing state (stream content was released). */
+    _nc->msg_ptr = NULL;
+    _nc->msg_len = 0;
+    _nc->vector = NULL;
+    _nc->vector_idx = 0;
+    _nc->vector_len = 0;
 
     return 0;
 }
+
+
+/**
+ab_can_write
+============
+
+Static dispatch entry points of the AB Codec (CAN frame stream). These
+functions call the codec implementation directly, rather than through the
+`NCodecInstance` vtable, bypassing the guard conditions and the trace and
+instrumentation interfaces of the Network Codec API. The gain is a direct
+(rather than indirect) call and fewer branches per message; calls to these
+functions are not inlined into the caller (unless the integration is built
+with link time optimisation). The codec object must represent a codec with
+MIMEtype parameters `type=frame; bus=can`.
+
+The following functions are available, with the same behaviour as the
+corresponding Network Codec API functions (the batch functions operate on
+an array of messages, i.e. `size` is implied):
+
+* `ab_can_write()` - `ncodec_write()`
+* `ab_can_read()` - `ncodec_read()`
+* `ab_can_write_batch()` - `ncodec_write_batch()`
+* `ab_can_read_batch()` - `ncodec_read_batch()`
+* `ab_can_flush()` - `ncodec_flush()`
+* `ab_can_truncate()` - `ncodec_truncate()`
+
+Parameters
+----------
+nc (NCODEC*)
+: Network Codec object (AB Codec).
+
+msg (NCodecCanMessage*)
+: The message (or array of messages), see the Network Codec API.
+
+Returns
+-------
+int32_t
+: See the corresponding Network Codec API function.
+*/
+int32_t ab_can_write(NCODEC* nc, NCodecCanMessage* msg)
+{
+    return can_write(nc, msg);
+}
+
+int32_t ab_can_read(NCODEC* nc, NCodecCanMessage* msg)
+{
+    return can_read(nc, msg);
+}
+
+int32_t ab_can_write_batch(
+    NCODEC* nc, NCodecCanMessage* msgs, size_t count)
+{
+    return can_write_batch(nc, msgs, count, sizeof(NCodecCanMessage));
+}
+
+int32_t ab_can_read_batch(
+    NCODEC* nc, NCodecCanMessage* msgs, size_t count)
+{
+    return can_read_batch(nc, msgs, count, sizeof(NCodecCanMessage));
+}
+
+int32_t ab_can_flush(NCODEC* nc)
+{
+    return can_flush(nc);
+}
+
+int32_t ab_can_truncate(NCODEC* nc)
+{
+    return can_truncate(nc);
+}
@@ -4,6 +4,7 @@
 
 #include <stdbool.h>
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 #include <dse/ncodec/codec.h>
 #include <dse/ncodec/codec/ab/codec.h>
@@ -15,15 +16,19 @@
 #define ns(x) FLATBUFFERS_WRAP_NAMESPACE(AutomotiveBus_Stream_Pdu, x)
 
 
-static void initialize_stream(ABCodecInstance* nc)
+static int32_t initialize_stream(ABCodecInstance* nc)
 {
-    if (nc->fbs_stream_initalized) return;
+    if (nc->fbs_stream_initalized) return 0;
 
-    flatcc_builder_t* B = &nc->fbs_builder;
-    flatcc_builder_reset(B);
+    /* The builder is initialised on first use (and reset after each stream). */
+    flatcc_builder_t* B = get_builder(nc);
+    if (B == NULL) return -ENOMEM;
     ns(Stream_start_as_root_with_size(B));
     ns(Stream_pdus_start(B));
     nc->fbs_stream_initalized = true;
+    nc->stream_sender = 0;
+    nc->stream_mixed = false;
+    return 0;
 }
 
 
@@ -31,26 +36,26 @@ static void reset_stream(ABCodecInstance* nc)
 {
     if (nc->fbs_stream_initalized == false) return;
 
-    flatcc_builder_t* B = &nc->fbs_builder;
-    flatcc_builder_reset(B);
+    reset_builder(nc);
     nc->fbs_stream_initalized = false;
 }
 
 
-static void finalize_stream(
-    ABCodecInstance* nc, uint8_t** buffer, size_t* length)
+static int32_t finalize_stream(ABCodecInstance* nc)
 {
-    if (nc->fbs_stream_initalized == false) {
-        *buffer = NULL;
-        *length = 0;
-        return;
-    }
+    if (nc->fbs_stream_initalized == false) return 0;
 
-    flatcc_builder_t* B = &nc->fbs_builder;
+    flatcc_builder_t* B = nc->fbs_builder;
     ns(Stream_pdus_end(B));
+    /* Sender index: only when all PDUs have the same (non zero) sender which
+       fits in the index (otherwise the stream is marked as mixed). */
+    if (nc->sender_index && nc->stream_sender && !nc->stream_mixed) {
+        ns(Stream_node_uid_add(B, AB_SENDER_INDEX(nc->stream_sender)));
+    }
     ns(Stream_end_as_root(B));
-    *buffer = flatcc_builder_finalize_buffer(B, length);
+    int32_t rc = emit_stream(nc);
     reset_stream(nc);
+    return rc;
 }
 
 
@@ -163,41 +168,120 @@ static uint32_t _emit_ip_message_metadata(flatcc_builder_t* B, NCodecPdu* _pdu)
     return ns(IpMessageMetadata_end(B));
 }
 
-static uint32_t _emit_struct_metadata(flatcc_builder_t* B, NCodecPdu* _pdu)
+/* Canonical copy of IP message metadata, padding and unused union members are
+   zero (supporting hash and memcmp). */
+static void _ip_metadata_canonical(
+    const NCodecPduIpMessageMetadata* ip, NCodecPduIpMessageMetadata* c)
 {
+    memset(c, 0, sizeof(NCodecPduIpMessageMetadata));
+    c->eth_dst_mac = ip->eth_dst_mac;
+    c->eth_src_mac = ip->eth_src_mac;
+    c->eth_ethertype = ip->eth_ethertype;
+    c->eth_tci_pcp = ip->eth_tci_pcp;
+    c->eth_tci_dei = ip->eth_tci_dei;
+    c->eth_tci_vid = ip->eth_tci_vid;
+    c->ip_protocol = ip->ip_protocol;
+    c->ip_addr_type = ip->ip_addr_type;
+    switch (ip->ip_addr_type) {
+    case NCodecPduIpAddrIPv4:
+        c->ip_addr.ip_v4 = ip->ip_addr.ip_v4;
+        break;
+    case NCodecPduIpAddrIPv6:
+        c->ip_addr.ip_v6 = ip->ip_addr.ip_v6;
+        break;
+    default:
+        break;
+    }
+    c->ip_src_port = ip->ip_src_port;
+    c->ip_dst_port = ip->ip_dst_port;
+    c->so_ad_type = ip->so_ad_type;
+    switch (ip->so_ad_type) {
+    case NCodecPduSoAdDoIP:
+        c->so_ad.do_ip.protocol_version = ip->so_ad.do_ip.protocol_version;
+        c->so_ad.do_ip.payload_type = ip->so_ad.do_ip.payload_type;
+        break;
+    case NCodecPduSoAdSomeIP:
+        c->so_ad.some_ip = ip->so_ad.some_ip;
+        break;
+    default:
+        break;
+    }
+}
+
+/* IP message metadata, referencing metadata emitted earlier in the stream
+   when identical (and cached). */
+static uint32_t _emit_ip_message_metadata_cached(
+    ABCodecInstance* nc, NCodecPdu* _pdu)
+{
+    flatcc_builder_t* B = nc->fbs_builder;
+    if (nc->metadata_cache == false) return _emit_ip_message_metadata(B, _pdu);
+
+    ABMetadataCache* cache = nc->ip_cache;
+    if (cache == NULL) {
+        cache = nc->ip_cache = calloc(1, sizeof(ABMetadataCache));
+        if (cache == NULL) return _emit_ip_message_metadata(B, _pdu);
+        cache->generation = 1;
+    }
+    NCodecPduIpMessageMetadata ip;
+    _ip_metadata_canonical(&_pdu->transport.ip_message, &ip);
+    /* FNV-1a. */
+    uint32_t       hash = 2166136261u;
+    const uint8_t* p = (const uint8_t*)&ip;
+    for (size_t i = 0; i < sizeof(ip); i++) {
+        hash = (hash ^ p[i]) * 16777619u;
+    }
+
+    ABMetadataEntry* e = &cache->entry[hash % AB_METADATA_CACHE_SIZE];
+    if (e->generation == cache->generation && e->hash == hash &&
+        memcmp(&e->ip, &ip, sizeof(ip)) == 0) {
+        return e->ref;
+    }
+    uint32_t ref = _emit_ip_message_metadata(B, _pdu);
+    if (ref) {
+        e->generation = cache->generation;
+        e->hash = hash;
+        memcpy(&e->ip, &ip, sizeof(ip));
+        e->ref = ref;
+    }
+    return ref;
+}
+
+static uint32_t _emit_struct_metadata(ABCodecInstance* nc, NCodecPdu* _pdu)
+{
+    flatcc_builder_t*        B = nc->fbs_builder;
     NCodecPduStructMetadata* struct_obj = &_pdu->transport.struct_object;
     ns(StructMetadata_start(B));
 
     if (struct_obj->type_name) {
         flatbuffers_string_ref_t _str;
-        _str = flatbuffers_string_create_str(B, struct_obj->type_name);
+        _str = intern_string(nc, struct_obj->type_name);
         ns(StructMetadata_type_name_add)(B, _str);
     }
     if (struct_obj->var_name) {
         flatbuffers_string_ref_t _str;
-        _str = flatbuffers_string_create_str(B, struct_obj->var_name);
+        _str = intern_string(nc, struct_obj->var_name);
         ns(StructMetadata_var_name_add)(B, _str);
     }
     if (struct_obj->encoding) {
         flatbuffers_string_ref_t _str;
-        _str = flatbuffers_string_create_str(B, struct_obj->encoding);
+        _str = intern_string(nc, struct_obj->encoding);
         ns(StructMetadata_encoding_add)(B, _str);
     }
     ns(StructMetadata_attribute_aligned_add(B, struct_obj->attribute_aligned));
     ns(StructMetadata_attribute_packed_add(B, struct_obj->attribute_packed));
     if (struct_obj->platform_arch) {
         flatbuffers_string_ref_t _str;
-        _str = flatbuffers_string_create_str(B, struct_obj->platform_arch);
+        _str = intern_string(nc, struct_obj->platform_arch);
         ns(StructMetadata_platform_arch_add)(B, _str);
     }
     if (struct_obj->platform_os) {
         flatbuffers_string_ref_t _str;
-        _str = flatbuffers_string_create_str(B, struct_obj->platform_os);
+        _str = intern_string(nc, struct_obj->platform_os);
         ns(StructMetadata_platform_os_add)(B, _str);
     }
     if (struct_obj->platform_abi) {
         flatbuffers_string_ref_t _str;
-        _str = flatbuffers_string_create_str(B, struct_obj->platform_abi);
+        _str = intern_string(nc, struct_obj->platform_abi);
         ns(StructMetadata_platform_abi_add)(B, _str);
     }
 
@@ -205,19 +289,12 @@ static uint32_t _emit_struct_metadata(flatcc_builder_t* B, NCodecPdu* _pdu)
 }
 
 
-int32_t pdu_write(NCODEC* nc, NCodecPdu* pdu)
+static int32_t _encode_pdu(ABCodecInstance* _nc, NCodecPdu* _pdu)
 {
-    ABCodecInstance* _nc = (ABCodecInstance*)nc;
-    NCodecPdu*       _pdu = (NCodecPdu*)pdu;
-    if (_nc == NULL) return -ENOSTR;
-    if (_pdu == NULL) return -EINVAL;
-    if (_nc->c.stream == NULL) return -ENOSR;
-
     uint32_t swc_id = _pdu->swc_id ? _pdu->swc_id : _nc->swc_id;
     uint32_t ecu_id = _pdu->ecu_id ? _pdu->ecu_id : _nc->ecu_id;
 
-    flatcc_builder_t* B = &_nc->fbs_builder;
-    initialize_stream(_nc);
+    flatcc_builder_t* B = _nc->fbs_builder;
     ns(CanMessageMetadata_ref_t) can_message_metadata = 0;
     ns(IpMessageMetadata_ref_t) ip_message_metadata = 0;
     ns(StructMetadata_ref_t) struct_metadata = 0;
@@ -229,10 +306,10 @@ int32_t pdu_write(NCODEC* nc, NCodecPdu* pdu)
         can_message_metadata = _emit_can_message_metadata(B, _pdu);
     } break;
     case NCodecPduTransportTypeIp: {
-        ip_message_metadata = _emit_ip_message_metadata(B, _pdu);
+        ip_message_metadata = _emit_ip_message_metadata_cached(_nc, _pdu);
     } break;
     case NCodecPduTransportTypeStruct: {
-        struct_metadata = _emit_struct_metadata(B, _pdu);
+        struct_metadata = _emit_struct_metadata(_nc, _pdu);
     } break;
     default:
         break;
@@ -254,10 +331,52 @@ int32_t pdu_write(NCODEC* nc, NCodecPdu* pdu)
     }
     ns(Stream_pdus_push_end(B));
 
+    if (swc_id == 0 || swc_id > AB_SENDER_INDEX_MAX ||
+        (_nc->stream_sender && _nc->stream_sender != swc_id)) {
+        _nc->stream_mixed = true;
+    }
+    _nc->stream_sender = swc_id;
+    _nc->stats.msg_written++;
+    _nc->stats.payload_written += _pdu->payload_len;
     return _pdu->payload_len;
 }
 
 
+int32_t pdu_write(NCODEC* nc, NCodecPdu* pdu)
+{
+    ABCodecInstance* _nc = (ABCodecInstance*)nc;
+    NCodecPdu*       _pdu = (NCodecPdu*)pdu;
+    if (_nc == NULL) return -ENOSTR;
+    if (_pdu == NULL) return -EINVAL;
+    if (_nc->c.stream == NULL) return -ENOSR;
+
+    int32_t rc = initialize_stream(_nc);
+    if (rc < 0) return rc;
+    return _encode_pdu(_nc, _pdu);
+}
+
+
+int32_t pdu_write_batch(NCODEC* nc, NCodecPdu* pdus, size_t count, size_t size)
+{
+    ABCodecInstance* _nc = (ABCodecInstance*)nc;
+    if (_nc == NULL) return -ENOSTR;
+    if (pdus == NULL || size < sizeof(NCodecPdu)) return -EINVAL;
+    if (_nc->c.stream == NULL) return -ENOSR;
+
+    if (count > INT32_MAX) count = INT32_MAX;
+
+    int32_t rc = initialize_stream(_nc);
+    if (rc < 0) return rc;
+    size_t i;
+    for (i = 0; i < count; i++) {
+        rc = _encode_pdu(_nc, (NCodecPdu*)((uint8_t*)pdus + i * size));
+        /* Stop at the first failed message. */
+        if (rc < 0) return i ? (int32_t)i : rc;
+    }
+    return i;
+}
+
+
 static void _decode_can_message_metadata(ns(Pdu_table_t) pdu, NCodecPdu* _pdu)
 {
     NCodecPduCanMessageMetadata* can = &_pdu->transport.can_message;
@@ -388,6 +507,74 @@ static void _decode_struct_metadata(ns(Pdu_table_t) pdu, NCodecPdu* _pdu)
 }
 
 
+static NCodecPduTransportType _transport_type(
+    ns(TransportMetadata_union_type_t) transport_type)
+{
+    switch (transport_type) {
+    case ns(TransportMetadata_Can):
+        return NCodecPduTransportTypeCan;
+    case ns(TransportMetadata_Ip):
+        return NCodecPduTransportTypeIp;
+    case ns(TransportMetadata_Struct):
+        return NCodecPduTransportTypeStruct;
+    default:
+        return NCodecPduTransportTypeNone;
+    }
+}
+
+
+/* Decode the transport metadata of a PDU. IP and struct metadata are cached,
+   keyed by the address of the transport table, so that PDUs referencing the
+   same table (see parameter `metadata_cache`) are decoded once. */
+static void _decode_transport(ABCodecInstance* nc, ns(Pdu_table_t) pdu,
+    NCodecPduTransportType type, NCodecPdu* _pdu)
+{
+    if (type == NCodecPduTransportTypeCan) {
+        _decode_can_message_metadata(pdu, _pdu);
+        return;
+    }
+    if (type != NCodecPduTransportTypeIp &&
+        type != NCodecPduTransportTypeStruct) {
+        return;
+    }
+
+    const void*    table = ns(Pdu_transport(pdu));
+    ABDecodeCache* cache = nc->decode_cache;
+    if (cache == NULL) {
+        cache = nc->decode_cache = calloc(1, sizeof(ABDecodeCache));
+        if (cache) cache->generation = 1;
+    }
+    ABDecodeEntry* e = NULL;
+    if (cache) {
+        e = &cache->entry[((uintptr_t)table >> 3) % AB_DECODE_CACHE_SIZE];
+        if (e->table == table && e->type == type &&
+            e->generation == cache->generation) {
+            _pdu->transport_type = type;
+            if (type == NCodecPduTransportTypeIp) {
+                _pdu->transport.ip_message = e->metadata.ip_message;
+            } else {
+                _pdu->transport.struct_object = e->metadata.struct_object;
+            }
+            return;
+        }
+    }
+
+    memset(&_pdu->transport, 0, sizeof(_pdu->transport));
+    if (type == NCodecPduTransportTypeIp) {
+        _decode_ip_message_metadata(pdu, _pdu);
+        if (e) e->metadata.ip_message = _pdu->transport.ip_message;
+    } else {
+        _decode_struct_metadata(pdu, _pdu);
+        if (e) e->metadata.struct_object = _pdu->transport.struct_object;
+    }
+    if (e) {
+        e->table = table;
+        e->type = type;
+        e->generation = cache->generation;
+    }
+}
+
+
 static void get_stream_from_buffer(NCODEC* nc)
 {
     ABCodecInstance* _nc = (ABCodecInstance*)nc;
@@ -399,32 +586,21 @@ static void get_stream_from_buffer(NCODEC* nc)
     _nc->vector_idx = 0;
     _nc->vector_len = 0;
 
-    /* Next message? */
-    uint8_t* buffer;
-    size_t   length;
-    _nc->c.stream->read(nc, &buffer, &length, NCODEC_POS_NC);
-
-    uint8_t*       msg_ptr = buffer;
-    uint8_t* const buffer_ptr = buffer;
-    while ((size_t)(msg_ptr - buffer_ptr) < length) {
-        /* Messages start with a size prefix. */
-        size_t msg_len = 0;
-        msg_ptr = flatbuffers_read_size_prefix(msg_ptr, &msg_len);
-        if (msg_len == 0) break;
-        /* Advance the stream pos (+4 for size prefix). */
-        _nc->c.stream->seek(nc, msg_len + 4, NCODEC_SEEK_CUR);
-        /* Set the parsing state. */
-        if (flatbuffers_has_identifier(msg_ptr, flatbuffers_identifier)) {
-            _nc->msg_ptr = msg_ptr;
-            _nc->msg_len = msg_len;
-            return;
+    /* Next message (from the message index of the stream). */
+    size_t   msg_len = 0;
+    uint8_t* msg_ptr =
+        index_next_message(_nc, flatbuffers_identifier, &msg_len);
+    if (msg_ptr) {
+        _nc->msg_ptr = msg_ptr;
+        _nc->msg_len = msg_len;
+        /* Decoded metadata is only valid for the message it was decoded
+           from (the stream content may be rewritten at the same address). */
+        ABDecodeCache* cache = _nc->decode_cache;
+        if (cache && ++cache->generation == 0) {
+            memset(cache, 0, sizeof(ABDecodeCache));
+            cache->generation = 1;
         }
-        /* Next message in the stream. */
-        msg_ptr += msg_len;
     }
-
-    /* No message in stream. */
-    _nc->c.stream->seek(nc, 0, NCODEC_SEEK_END);
 }
 
 static void get_vector_from_stream(NCODEC* nc)
@@ -443,15 +619,41 @@ static void get_vector_from_stream(NCODEC* nc)
     ns(Stream_table_t) stream = ns(Stream_as_root(_nc->msg_ptr));
     _nc->vector = ns(Stream_pdus(stream));
     _nc->vector_len = ns(Pdu_vec_len(_nc->vector));
+
+    /* Sender index: skip streams sent by this codec (sender==receiver). */
+    if (_nc->sender_index && _nc->swc_id &&
+        ns(Stream_node_uid(stream)) == AB_SENDER_INDEX(_nc->swc_id)) {
+        _nc->stats.msg_filtered += _nc->vector_len;
+        _nc->vector_idx = _nc->vector_len;
+    }
 }
 
-int32_t pdu_read(NCODEC* nc, NCodecPdu* pdu)
+/* Record a PDU with pending transport metadata, returns false if the entry
+   could not be allocated (the metadata is then decoded immediately). */
+static bool _lazy_add(
+    ABCodecInstance* nc, const NCodecPdu* _pdu, ns(Pdu_table_t) pdu)
 {
-    ABCodecInstance* _nc = (ABCodecInstance*)nc;
-    NCodecPdu*       _pdu = (NCodecPdu*)pdu;
-    if (_nc == NULL) return -ENOSTR;
-    if (_pdu == NULL) return -EINVAL;
-    if (_nc->c.stream == NULL) return -ENOSR;
+    ABLazyList* l = &nc->decode_pending;
+    if (l->count == l->capacity) {
+        size_t       capacity = l->capacity ? l->capacity * 2 : 16;
+        ABLazyEntry* entries =
+            realloc(l->entries, capacity * sizeof(ABLazyEntry));
+        if (entries == NULL) return false;
+        l->entries = entries;
+        l->capacity = capacity;
+    }
+    l->entries[l->count++] = (ABLazyEntry){
+        .pdu = _pdu,
+        .payload = _pdu->payload,
+        .id = _pdu->id,
+        .table = pdu,
+    };
+    return true;
+}
+
+static int32_t _decode_pdu(ABCodecInstance* _nc, NCodecPdu* _pdu)
+{
+    NCODEC* nc = (NCODEC*)_nc;
 
     /* Reset the message, in case caller ignores the return value. */
     _pdu->payload_len = 0;
@@ -465,10 +667,20 @@ int32_t pdu_read(NCODEC* nc, NCodecPdu* pdu)
             ns(Pdu_table_t) pdu = ns(Pdu_vec_at(_nc->vector, _vi));
 
             /* Filter: sender==receiver. */
-            if ((_nc->swc_id) && (_nc->swc_id == ns(Pdu_swc_id(pdu)))) continue;
+            if ((_nc->swc_id) && (_nc->swc_id == ns(Pdu_swc_id(pdu)))) {
+                _nc->stats.msg_filtered++;
+                continue;
+            }
+
+            /* Filter: receive filter (before the message is decoded). */
+            uint32_t id = ns(Pdu_id(pdu));
+            if (!filter_accept(_nc->filter, id)) {
+                _nc->stats.msg_rejected++;
+                continue;
+            }
 
             /* Return the message. */
-            _pdu->id = ns(Pdu_id(pdu));
+            _pdu->id = id;
             flatbuffers_uint8_vec_t payload = ns(Pdu_payload(pdu));
             _pdu->payload = (uint8_t*)payload;
             _pdu->payload_len = flatbuffers_uint8_vec_len(payload);
@@ -476,19 +688,21 @@ int32_t pdu_read(NCODEC* nc, NCodecPdu* pdu)
             _pdu->ecu_id = ns(Pdu_ecu_id(pdu));
 
             if (ns(Pdu_transport_is_present(pdu))) {
-                ns(TransportMetadata_union_type_t) transport_type =
-                    ns(Pdu_transport_type(pdu));
-                if (transport_type == ns(TransportMetadata_Can)) {
-                    _decode_can_message_metadata(pdu, _pdu);
-                } else if (transport_type == ns(TransportMetadata_Ip)) {
-                    _decode_ip_message_metadata(pdu, _pdu);
-                } else if (transport_type == ns(TransportMetadata_Struct)) {
-                    _decode_struct_metadata(pdu, _pdu);
+                NCodecPduTransportType transport_type =
+                    _transport_type(ns(Pdu_transport_type(pdu)));
+                if (_nc->decode_lazy && _lazy_add(_nc, _pdu, pdu)) {
+                    /* Decoded on demand, see ab_pdu_transport(). */
+                    _pdu->transport_type = transport_type;
+                    memset(&_pdu->transport, 0, sizeof(_pdu->transport));
+                } else {
+                    _decode_transport(_nc, pdu, transport_type, _pdu);
                 }
             }
 
             /* ... but don't forget to save the vector index either. */
             _nc->vector_idx = _vi + 1;
+            _nc->stats.msg_read++;
+            _nc->stats.payload_read += _pdu->payload_len;
             return _pdu->payload_len;
         }
 
@@ -502,21 +716,45 @@ int32_t pdu_read(NCODEC* nc, NCodecPdu* pdu)
 }
 
 
-int32_t pdu_flush(NCODEC* nc)
+int32_t pdu_read(NCODEC* nc, NCodecPdu* pdu)
 {
     ABCodecInstance* _nc = (ABCodecInstance*)nc;
+    NCodecPdu*       _pdu = (NCodecPdu*)pdu;
     if (_nc == NULL) return -ENOSTR;
+    if (_pdu == NULL) return -EINVAL;
     if (_nc->c.stream == NULL) return -ENOSR;
 
-    uint8_t* buffer = NULL;
-    size_t   length = 0;
+    return _decode_pdu(_nc, _pdu);
+}
 
-    finalize_stream(_nc, &buffer, &length);
-    if (buffer) {
-        _nc->c.stream->write(nc, buffer, length);
-        free(buffer);
+
+int32_t pdu_read_batch(NCODEC* nc, NCodecPdu* pdus, size_t count, size_t size)
+{
+    ABCodecInstance* _nc = (ABCodecInstance*)nc;
+    if (_nc == NULL) return -ENOSTR;
+    if (pdus == NULL || size < sizeof(NCodecPdu)) return -EINVAL;
+    if (_nc->c.stream == NULL) return -ENOSR;
+
+    if (count > INT32_MAX) count = INT32_MAX;
+
+    size_t i;
+    for (i = 0; i < count; i++) {
+        NCodecPdu* _pdu = (NCodecPdu*)((uint8_t*)pdus + i * size);
+        if (_decode_pdu(_nc, _pdu) < 0) break;
     }
-    return length;
+    if (i == 0 && count) return -ENOMSG;
+    return i;
+}
+
+
+int32_t pdu_flush(NCODEC* nc)
+{
+    ABCodecInstance* _nc = (ABCodecInstance*)nc;
+    if (_nc == NULL) return -ENOSTR;
+    if (_nc->c.stream == NULL) return -ENOSR;
+
+    _nc->stats.flush_count++;
+    return finalize_stream(_nc);
 }
 
 
@@ -528,6 +766,140 @@ int32_t pdu_truncate(NCODEC* nc)
 
     reset_stream(_nc);
     _nc->c.stream->seek(nc, 0, NCODEC_SEEK_RESET);
+    index_reset(_nc);
+    _nc->decode_pending.count = 0;
+    /* Reset the message parsing state (stream content was released). */
+    _nc->msg_ptr = NULL;
+    _nc->msg_len = 0;
+    _nc->vector = NULL;
+    _nc->vector_idx = 0;
+    _nc->vector_len = 0;
+
+    return 0;
+}
+
+
+/**
+ab_pdu_write
+============
+
+Static dispatch entry points of the AB Codec (PDU stream). These
+functions call the codec implementation directly, rather than through the
+`NCodecInstance` vtable, bypassing the guard conditions and the trace and
+instrumentation interfaces of the Network Codec API. The gain is a direct
+(rather than indirect) call and fewer branches per message; calls to these
+functions are not inlined into the caller (unless the integration is built
+with link time optimisation). The codec object must represent a codec with
+MIMEtype parameters `type=pdu`.
+
+The following functions are available, with the same behaviour as the
+corresponding Network Codec API functions (the batch functions operate on
+an array of messages, i.e. `size` is implied):
+
+* `ab_pdu_write()` - `ncodec_write()`
+* `ab_pdu_read()` - `ncodec_read()`
+* `ab_pdu_write_batch()` - `ncodec_write_batch()`
+* `ab_pdu_read_batch()` - `ncodec_read_batch()`
+* `ab_pdu_flush()` - `ncodec_flush()`
+* `ab_pdu_truncate()` - `ncodec_truncate()`
+
+Parameters
+----------
+nc (NCODEC*)
+: Network Codec object (AB Codec).
+
+pdu (NCodecPdu*)
+: The message (or array of messages), see the Network Codec API.
+
+Returns
+-------
+int32_t
+: See the corresponding Network Codec API function.
+*/
+int32_t ab_pdu_write(NCODEC* nc, NCodecPdu* pdu)
+{
+    return pdu_write(nc, pdu);
+}
+
+int32_t ab_pdu_read(NCODEC* nc, NCodecPdu* pdu)
+{
+    return pdu_read(nc, pdu);
+}
+
+int32_t ab_pdu_write_batch(NCODEC* nc, NCodecPdu* pdus, size_t count)
+{
+    return pdu_write_batch(nc, pdus, count, sizeof(NCodecPdu));
+}
+
+int32_t ab_pdu_read_batch(NCODEC* nc, NCodecPdu* pdus, size_t count)
+{
+    return pdu_read_batch(nc, pdus, count, sizeof(NCodecPdu));
+}
+
+int32_t ab_pdu_flush(NCODEC* nc)
+{
+    return pdu_flush(nc);
+}
 
+int32_t ab_pdu_truncate(NCODEC* nc)
+{
+    return pdu_truncate(nc);
+}
+
+
+/**
+ab_pdu_transport
+================
+
+Decode the transport metadata of a PDU which was read by a codec configured
+with the parameter `decode=lazy`. In that mode `ncodec_read()` returns the
+PDU with its `transport_type` set and `transport` cleared; the codec keeps a
+reference to the encoded metadata (valid until the stream is truncated) which
+is only decoded (into `transport`) when this function is called. The PDU is
+identified by its `id` and `payload` (a copy of the PDU object may be used),
+or by the PDU object if it has no payload. Further calls (or calls for PDUs
+without pending metadata, i.e. codecs not configured for lazy decoding) do
+not modify the PDU. Call this function before forwarding a PDU with
+`ncodec_write()`, otherwise the PDU is written with cleared metadata.
+
+Parameters
+----------
+nc (NCODEC*)
+: Network Codec object (AB Codec, PDU).
+
+pdu (NCodecPdu*)
+: The PDU, as returned by `ncodec_read()`.
+
+Returns
+-------
+0
+: The transport metadata is decoded (or no metadata was pending).
+
+-ENOSTR
+: The object represented by `nc` does not represent a valid stream.
+
+-EINVAL
+: The PDU parameter is not valid.
+*/
+int32_t ab_pdu_transport(NCODEC* nc, NCodecPdu* pdu)
+{
+    ABCodecInstance* _nc = (ABCodecInstance*)nc;
+    if (_nc == NULL) return -ENOSTR;
+    if (pdu == NULL) return -EINVAL;
+
+    /* Search from the most recently read PDU. */
+    ABLazyList* l = &_nc->decode_pending;
+    for (size_t i = l->count; i > 0; i--) {
+        ABLazyEntry* e = &l->entries[i - 1];
+        if (e->table == NULL || e->id != pdu->id) continue;
+        if (e->payload != pdu->payload) continue;
+        if (e->payload == NULL && e->pdu != pdu) continue;
+
+        ns(Pdu_table_t) encoded = e->table;
+        e->table = NULL;
+        memset(&pdu->transport, 0, sizeof(pdu->transport));
+        _decode_transport(_nc, encoded, pdu->transport_type, pdu);
+        break;
+    }
     return 0;
 }
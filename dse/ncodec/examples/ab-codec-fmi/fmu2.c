@@ -9,6 +9,7 @@
 #include <dse/ncodec/codec.h>
 #include <dse/ncodec/interface/pdu.h>
 #include <dse/ncodec/stream/stream.h>
+#include <dse/ncodec/stream/transport.h>
 
 #define UNUSED(x) ((void)x)
 #define MIMETYPE                                                               \
@@ -18,6 +19,10 @@
 #define VR_RX 1  // RX from perspective of FMU
 #define VR_TX 2  // TX from perspective of FMU
 
+#define TRANSPORT getenv("NCODEC_TRANSPORT")
+#define fmi2OK    0  // fmi2Status
+#define fmi2Error 3
+
 static char* _rx_tx_buffer = NULL;
 
 int fmi2GetString(void* c, const unsigned int vr[], size_t nvr, char* value[])
@@ -51,10 +56,15 @@ int fmi2DoStep(void* c, double currentCommunicationPoint,
     size_t   buffer_len = 0;
 
     /* RX Codec - setup buffer and prime for reading. */
-    buffer = (uint8_t*)ascii85_decode(_rx_tx_buffer, &buffer_len);
+    const NCodecTransport* transport = ncodec_transport(TRANSPORT);
+    if (transport == NULL) return fmi2Error;
+    buffer = ncodec_transport_decode(
+        transport, _rx_tx_buffer, strlen(_rx_tx_buffer), &buffer_len);
+    if (buffer == NULL) return fmi2Error;
     free(_rx_tx_buffer);
     NCODEC* rx_nc = ncodec_open(MIMETYPE, ncodec_buffer_stream_create(0));
     ((NCodecInstance*)rx_nc)->stream->write(rx_nc, buffer, buffer_len);
+    free(buffer);
     ncodec_seek(rx_nc, 0, NCODEC_SEEK_SET);
 
     /* TX Codec - note `swc_id` is different from main.c to avoid filtering. */
@@ -77,11 +87,11 @@ int fmi2DoStep(void* c, double currentCommunicationPoint,
     ncodec_seek(tx_nc, 0, NCODEC_SEEK_SET);
     ((NCodecInstance*)tx_nc)
         ->stream->read(tx_nc, &buffer, &buffer_len, NCODEC_POS_NC);
-    _rx_tx_buffer = ascii85_encode((char*)buffer, buffer_len);
+    _rx_tx_buffer = ncodec_transport_encode(transport, buffer, buffer_len, NULL);
 
     /* Destroy the NCodec objects. */
     ncodec_close(rx_nc);
     ncodec_close(tx_nc);
 
-    return 0;
+    return fmi2OK;
 }
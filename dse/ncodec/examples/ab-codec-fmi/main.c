@@ -2,6 +2,7 @@
 //
 // SPDX-License-Identifier: Apache-2.0
 
+#include <errno.h>
 #include <stdarg.h>
 #include <stddef.h>
 #include <stdio.h>
@@ -10,6 +11,7 @@
 #include <dse/ncodec/codec.h>
 #include <dse/ncodec/interface/pdu.h>
 #include <dse/ncodec/stream/stream.h>
+#include <dse/ncodec/stream/transport.h>
 
 #define MIMETYPE                                                               \
     "application/x-automotive-bus; "                                           \
@@ -18,6 +20,7 @@
 #define BUFFER_LEN 1024  // Initial buffer size, will grow as needed.
 #define VR_RX      1     // RX from perspective of FMU
 #define VR_TX      2     // TX from perspective of FMU
+#define TRANSPORT  getenv("NCODEC_TRANSPORT")  // ascii85 (default) or base64.
 
 extern int fmi2GetString(
     void* c, const unsigned int vr[], size_t nvr, char* value[]);
@@ -53,6 +56,12 @@ int main(void)
     size_t      buffer_len;
     char*       fmi_string;
 
+    /* Select the transport, FMI 2 String Variables require a text transport. */
+    const NCodecTransport* transport = ncodec_transport(TRANSPORT);
+    if (transport == NULL || transport->text == false) {
+        return _ncodec_fault("ncodec_transport", -EINVAL);
+    }
+
     /* Create the NCODEC object with a simple buffer stream. */
     NCodecStreamVTable* stream = ncodec_buffer_stream_create(BUFFER_LEN);
     NCODEC*             nc = ncodec_open(MIMETYPE, stream);
@@ -71,9 +80,10 @@ int main(void)
     rc = ncodec_seek(nc, 0, NCODEC_SEEK_SET);
     if (rc) return _ncodec_fault("ncodec_seek", rc);
     stream->read(nc, &buffer, &buffer_len, NCODEC_POS_NC);
-    fmi_string = ascii85_encode((char*)buffer, buffer_len);
+    fmi_string = ncodec_transport_encode(transport, buffer, buffer_len, NULL);
+    if (fmi_string == NULL) return _ncodec_fault("transport encode", -errno);
     _log("BUFFER TX", "(%d)", buffer_len);
-    _log("ASCII85 TX", "(%d) %s", strlen(fmi_string), fmi_string);
+    _log("ENCODED TX", "(%d) %s", strlen(fmi_string), fmi_string);
 
     /* Interact with the FMU for a single Co-Simulation step. */
     rc = ncodec_truncate(nc);
@@ -82,14 +92,16 @@ int main(void)
         NULL, (unsigned int[]){ VR_RX }, 1, (const char*[]){ fmi_string });
     free(fmi_string); /* Release the fmi_string, FMU will have a copy. */
     fmi_string = NULL;
-    fmi2DoStep(NULL, 0.0, 0.0005, false);
+    rc = fmi2DoStep(NULL, 0.0, 0.0005, false);
+    if (rc) return _ncodec_fault("fmi2DoStep", -EIO);
     char* v[] = { NULL };
     fmi2GetString(NULL, (unsigned int[]){ VR_TX }, 1, v);
     if (v[0] == NULL) return _ncodec_fault("fmi2GetString - no data", -ENODATA);
 
     /* Decode the FMI 2 String Variable and inject into the stream buffer. */
-    _log("ASCII85 RX", "(%d) %s", strlen(v[0]), v[0]);
-    buffer = (uint8_t*)ascii85_decode(v[0], &buffer_len);
+    _log("ENCODED RX", "(%d) %s", strlen(v[0]), v[0]);
+    buffer = ncodec_transport_decode(transport, v[0], strlen(v[0]), &buffer_len);
+    if (buffer == NULL) return _ncodec_fault("transport decode", -errno);
     _log("BUFFER RX", "(%d)", buffer_len);
     stream->write(nc, buffer, buffer_len);
     free(buffer);
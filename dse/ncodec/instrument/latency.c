@@ -0,0 +1,242 @@
+// Copyright 2025 Robert Bosch GmbH
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <dse/platform.h>
+#include <dse/ncodec/codec.h>
+#include <dse/ncodec/instrument/latency.h>
+
+
+#define SUB_BITS  NCODEC_HISTOGRAM_SUB_BITS
+#define SUB_COUNT (1 << SUB_BITS)
+#define SUB_HALF  (SUB_COUNT >> 1)
+
+
+static inline uint64_t _now(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_SOURCE, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+
+/* Bucket index: values below SUB_COUNT map directly, larger values map to
+   SUB_HALF sub-buckets per power of 2. */
+static inline size_t _bucket_index(uint64_t value)
+{
+    if (value < SUB_COUNT) return value;
+    int    shift = (63 - __builtin_clzll(value)) - (SUB_BITS - 1);
+    size_t index = shift * SUB_HALF + (value >> shift);
+    if (index >= NCODEC_HISTOGRAM_BUCKETS) index = NCODEC_HISTOGRAM_BUCKETS - 1;
+    return index;
+}
+
+/* Highest value represented by a bucket. */
+static inline uint64_t _bucket_value(size_t index)
+{
+    if (index < SUB_COUNT) return index;
+    int      shift = index / SUB_HALF - 1;
+    uint64_t sub = index % SUB_HALF + SUB_HALF;
+    return ((sub + 1) << shift) - 1;
+}
+
+
+/**
+ncodec_histogram_record
+=======================
+
+Record a value in a histogram.
+
+Parameters
+----------
+h (NCodecHistogram*)
+: The histogram.
+
+value (uint64_t)
+: The value to record (e.g. a latency in nanoseconds).
+*/
+void ncodec_histogram_record(NCodecHistogram* h, uint64_t value)
+{
+    if (h == NULL) return;
+
+    h->buckets[_bucket_index(value)]++;
+    if (h->count == 0 || value < h->min) h->min = value;
+    if (value > h->max) h->max = value;
+    h->sum += value;
+    h->count++;
+}
+
+
+/**
+ncodec_histogram_percentile
+===========================
+
+Get the value at a percentile of the recorded values.
+
+Parameters
+----------
+h (const NCodecHistogram*)
+: The histogram.
+
+percentile (double)
+: The percentile (0.0 .. 100.0).
+
+Returns
+-------
+uint64_t
+: The highest value equivalent (within the resolution of the histogram) to
+  the value at the percentile, limited to the maximum recorded value. 0 if no
+  values were recorded.
+*/
+uint64_t ncodec_histogram_percentile(
+    const NCodecHistogram* h, double percentile)
+{
+    if (h == NULL || h->count == 0) return 0;
+
+    if (percentile < 0.0) percentile = 0.0;
+    if (percentile > 100.0) percentile = 100.0;
+    uint64_t rank = (uint64_t)(percentile / 100.0 * h->count + 0.5);
+    if (rank == 0) rank = 1;
+    uint64_t total = 0;
+    for (size_t i = 0; i < NCODEC_HISTOGRAM_BUCKETS; i++) {
+        total += h->buckets[i];
+        if (total >= rank) {
+            /* The last bucket also holds values beyond the histogram range. */
+            if (i == NCODEC_HISTOGRAM_BUCKETS - 1) return h->max;
+            uint64_t value = _bucket_value(i);
+            return value < h->max ? value : h->max;
+        }
+    }
+    return h->max;
+}
+
+
+/**
+ncodec_histogram_reset
+======================
+
+Reset a histogram (i.e. remove all recorded values).
+
+Parameters
+----------
+h (NCodecHistogram*)
+: The histogram.
+*/
+void ncodec_histogram_reset(NCodecHistogram* h)
+{
+    if (h == NULL) return;
+    memset(h, 0, sizeof(NCodecHistogram));
+}
+
+
+static void _latency_begin(NCODEC* nc, int32_t op)
+{
+    NCodecLatency* l = ((NCodecInstance*)nc)->instrument.data;
+    if (l && (uint32_t)op < __NCODEC_OP_COUNT__) l->begin[op] = _now();
+}
+
+static void _latency_end(NCODEC* nc, int32_t op, int32_t rc)
+{
+    (void)rc;
+    NCodecLatency* l = ((NCodecInstance*)nc)->instrument.data;
+    if (l && (uint32_t)op < __NCODEC_OP_COUNT__) {
+        ncodec_histogram_record(&l->op[op], _now() - l->begin[op]);
+    }
+}
+
+
+/**
+ncodec_latency_attach
+=====================
+
+Attach latency instrumentation to a Network Codec. The latency of each codec
+operation is recorded in a histogram (per operation), which can be inspected
+at any time. The instrumentation is detached (and released) when the codec is
+closed.
+
+Parameters
+----------
+nc (NCODEC*)
+: Network Codec object.
+
+Returns
+-------
+NCodecLatency*
+: The latency histograms, indexed by `NCodecOperation`.
+
+NULL
+: The instrumentation could not be attached (errno is set). EBUSY indicates
+  that the codec already has (other) instrumentation attached.
+*/
+NCodecLatency* ncodec_latency_attach(NCODEC* nc)
+{
+    NCodecInstance* _nc = (NCodecInstance*)nc;
+    if (_nc == NULL) {
+        errno = ENOSTR;
+        return NULL;
+    }
+    if (_nc->instrument.begin == _latency_begin) return _nc->instrument.data;
+    if (_nc->instrument.begin || _nc->instrument.end) {
+        errno = EBUSY;
+        return NULL;
+    }
+
+    NCodecLatency* l = calloc(1, sizeof(NCodecLatency));
+    if (l == NULL) return NULL;
+    _nc->instrument = (NCodecInstrumentVTable){
+        .begin = _latency_begin,
+        .end = _latency_end,
+        .close = ncodec_latency_detach,
+        .data = l,
+    };
+    return l;
+}
+
+
+/**
+ncodec_latency
+==============
+
+Parameters
+----------
+nc (NCODEC*)
+: Network Codec object.
+
+Returns
+-------
+NCodecLatency*
+: The latency histograms of the codec, or NULL if latency instrumentation is
+  not attached.
+*/
+NCodecLatency* ncodec_latency(NCODEC* nc)
+{
+    NCodecInstance* _nc = (NCodecInstance*)nc;
+    if (_nc == NULL || _nc->instrument.begin != _latency_begin) return NULL;
+    return _nc->instrument.data;
+}
+
+
+/**
+ncodec_latency_detach
+=====================
+
+Detach latency instrumentation from a Network Codec, and release the
+histograms.
+
+Parameters
+----------
+nc (NCODEC*)
+: Network Codec object.
+*/
+void ncodec_latency_detach(NCODEC* nc)
+{
+    NCodecInstance* _nc = (NCodecInstance*)nc;
+    if (_nc == NULL || _nc->instrument.begin != _latency_begin) return;
+
+    free(_nc->instrument.data);
+    _nc->instrument = (NCodecInstrumentVTable){ 0 };
+}
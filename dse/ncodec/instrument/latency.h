@@ -0,0 +1,55 @@
+// Copyright 2025 Robert Bosch GmbH
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef DSE_NCODEC_INSTRUMENT_LATENCY_H_
+#define DSE_NCODEC_INSTRUMENT_LATENCY_H_
+
+#include <stdint.h>
+#include <dse/platform.h>
+#include <dse/ncodec/codec.h>
+
+
+/**
+Latency Instrumentation
+=======================
+
+Latency histograms, per codec operation (`NCodecOperation`), recorded with
+the instrumentation interface of the Network Codec API.
+
+The histograms are log-linear (HDR style): values are recorded in
+nanoseconds with a resolution of 1/16 (i.e. 6.25%) of the value, up to a
+maximum of 2^40 ns (larger values are recorded in the last bucket).
+*/
+
+#define NCODEC_HISTOGRAM_SUB_BITS 5
+#define NCODEC_HISTOGRAM_MAX_BITS 40
+#define NCODEC_HISTOGRAM_BUCKETS                                               \
+    ((NCODEC_HISTOGRAM_MAX_BITS - NCODEC_HISTOGRAM_SUB_BITS + 2)               \
+        << (NCODEC_HISTOGRAM_SUB_BITS - 1))
+
+typedef struct NCodecHistogram {
+    uint64_t count;
+    uint64_t min;
+    uint64_t max;
+    uint64_t sum;
+    uint64_t buckets[NCODEC_HISTOGRAM_BUCKETS];
+} NCodecHistogram;
+
+typedef struct NCodecLatency {
+    uint64_t        begin[__NCODEC_OP_COUNT__];
+    NCodecHistogram op[__NCODEC_OP_COUNT__];
+} NCodecLatency;
+
+
+/* latency.c */
+DLL_PUBLIC void     ncodec_histogram_record(NCodecHistogram* h, uint64_t value);
+DLL_PUBLIC uint64_t ncodec_histogram_percentile(
+    const NCodecHistogram* h, double percentile);
+DLL_PUBLIC void     ncodec_histogram_reset(NCodecHistogram* h);
+DLL_PUBLIC NCodecLatency* ncodec_latency_attach(NCODEC* nc);
+DLL_PUBLIC NCodecLatency* ncodec_latency(NCODEC* nc);
+DLL_PUBLIC void           ncodec_latency_detach(NCODEC* nc);
+
+
+#endif  // DSE_NCODEC_INSTRUMENT_LATENCY_H_
@@ -2,11 +2,514 @@
 //
 // SPDX-License-Identifier: Apache-2.0
 
+#include <errno.h>
 #include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
-#include <math.h>
+#include <dse/platform.h>
+#include <dse/ncodec/stream/stream.h>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define ASCII85_X86 1
+#include <immintrin.h>
+#endif
+
+
+/* Division by 85, exact for all uint32_t values. */
+#define DIV85(x) ((uint32_t)(((uint64_t)(x)*0xC0C0C0C1ULL) >> 38))
+
+#define ASCII85_ISA_SCALAR 0
+#define ASCII85_ISA_SSE41  1
+#define ASCII85_ISA_AVX2   2
+
+
+static int __isa = -1;
+
+
+static int _isa(void)
+{
+    if (__isa >= 0) return __isa;
+    __isa = ASCII85_ISA_SCALAR;
+#if defined(ASCII85_X86)
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+        __isa = ASCII85_ISA_AVX2;
+    } else if (__builtin_cpu_supports("sse4.1")) {
+        __isa = ASCII85_ISA_SSE41;
+    }
+#endif
+    return __isa;
+}
+
+
+/* Select the instruction set (limited to what the CPU supports), for testing.
+   Returns the selected instruction set. */
+DLL_PRIVATE int ascii85_select_isa(int isa)
+{
+    __isa = -1;
+    int supported = _isa();
+    __isa = (isa >= 0 && isa < supported) ? isa : supported;
+    return __isa;
+}
+
+
+static inline void _encode_group(uint32_t x, char* dst)
+{
+    for (int i = 4; i >= 0; i--) {
+        uint32_t q = DIV85(x);
+        dst[i] = (char)(x - q * 85 + 33);
+        x = q;
+    }
+}
+
+
+static inline uint32_t _load_group(const uint8_t* src)
+{
+    return (uint32_t)src[0] << 24 | (uint32_t)src[1] << 16 |
+           (uint32_t)src[2] << 8 | (uint32_t)src[3];
+}
+
+
+#if defined(ASCII85_X86)
+
+/* Emit encoded groups, the characters of each group are packed (first 4
+   characters in lo, the 5th character in hi). Each group is stored with a
+   single 8 byte (overlapping) write, the caller ensures the destination has
+   capacity for the additional 3 bytes. */
+static inline char* _emit_groups(
+    const uint32_t* lo, const uint32_t* hi, size_t count, int zmask, char* d)
+{
+    for (size_t g = 0; g < count; g++) {
+        if (zmask & (1 << g)) {
+            *d++ = 'z';
+            continue;
+        }
+        uint64_t w = (uint64_t)hi[g] << 32 | lo[g];
+        memcpy(d, &w, sizeof(w));
+        d += 5;
+    }
+    return d;
+}
+
+
+__attribute__((target("avx2"))) static size_t _encode_blocks_avx2(
+    const uint8_t* src, size_t groups, char** dst)
+{
+    const __m256i bswap = _mm256_setr_epi8(3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9,
+        8, 15, 14, 13, 12, 3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12);
+    const __m256i magic = _mm256_set1_epi32((int)0xC0C0C0C1);
+    const __m256i k85 = _mm256_set1_epi32(85);
+    const __m256i k33 = _mm256_set1_epi32(33);
+    char*         d = *dst;
+    size_t        g;
+
+    for (g = 0; g + 8 <= groups; g += 8) {
+        __m256i x = _mm256_loadu_si256((const __m256i*)(src + g * 4));
+        x = _mm256_shuffle_epi8(x, bswap);
+        int zmask = _mm256_movemask_ps(_mm256_castsi256_ps(
+            _mm256_cmpeq_epi32(x, _mm256_setzero_si256())));
+        __m256i lo = _mm256_set1_epi32(0x21212121);
+        __m256i hi = k33;
+        for (int i = 4; i >= 0; i--) {
+            __m256i even = _mm256_srli_epi64(_mm256_mul_epu32(x, magic), 38);
+            __m256i odd = _mm256_srli_epi64(
+                _mm256_mul_epu32(_mm256_srli_epi64(x, 32), magic), 38);
+            __m256i q = _mm256_blend_epi32(even, _mm256_slli_epi64(odd, 32), 0xAA);
+            __m256i r = _mm256_sub_epi32(x, _mm256_mullo_epi32(q, k85));
+            if (i == 4) {
+                hi = _mm256_add_epi32(hi, r);
+            } else {
+                lo = _mm256_add_epi32(lo, _mm256_sllv_epi32(r,
+                                              _mm256_set1_epi32(i * 8)));
+            }
+            x = q;
+        }
+        uint32_t _lo[8], _hi[8];
+        _mm256_storeu_si256((__m256i*)_lo, lo);
+        _mm256_storeu_si256((__m256i*)_hi, hi);
+        d = _emit_groups(_lo, _hi, 8, zmask, d);
+    }
+    *dst = d;
+    return g;
+}
+
+
+__attribute__((target("sse4.1"))) static size_t _encode_blocks_sse41(
+    const uint8_t* src, size_t groups, char** dst)
+{
+    const __m128i bswap =
+        _mm_setr_epi8(3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12);
+    const __m128i magic = _mm_set1_epi32((int)0xC0C0C0C1);
+    const __m128i k85 = _mm_set1_epi32(85);
+    const __m128i k33 = _mm_set1_epi32(33);
+    char*         d = *dst;
+    size_t        g;
+
+    for (g = 0; g + 4 <= groups; g += 4) {
+        __m128i x = _mm_loadu_si128((const __m128i*)(src + g * 4));
+        x = _mm_shuffle_epi8(x, bswap);
+        int zmask = _mm_movemask_ps(
+            _mm_castsi128_ps(_mm_cmpeq_epi32(x, _mm_setzero_si128())));
+        __m128i lo = _mm_set1_epi32(0x21212121);
+        __m128i hi = k33;
+        for (int i = 4; i >= 0; i--) {
+            __m128i even = _mm_srli_epi64(_mm_mul_epu32(x, magic), 38);
+            __m128i odd =
+                _mm_srli_epi64(_mm_mul_epu32(_mm_srli_epi64(x, 32), magic), 38);
+            __m128i q = _mm_blend_epi16(even, _mm_slli_epi64(odd, 32), 0xCC);
+            __m128i r = _mm_sub_epi32(x, _mm_mullo_epi32(q, k85));
+            if (i == 4) {
+                hi = _mm_add_epi32(hi, r);
+            } else {
+                lo = _mm_add_epi32(lo, _mm_sll_epi32(r, _mm_cvtsi32_si128(i * 8)));
+            }
+            x = q;
+        }
+        uint32_t _lo[4], _hi[4];
+        _mm_storeu_si128((__m128i*)_lo, lo);
+        _mm_storeu_si128((__m128i*)_hi, hi);
+        d = _emit_groups(_lo, _hi, 4, zmask, d);
+    }
+    *dst = d;
+    return g;
+}
+
+
+/* Decode blocks of 8 groups (40 characters, without 'z'). Returns the number
+   of characters consumed. */
+__attribute__((target("avx2"))) static size_t _decode_blocks_avx2(
+    const char* src, size_t src_len, uint8_t** dst, size_t dst_cap)
+{
+    const __m256i bswap = _mm256_setr_epi8(3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9,
+        8, 15, 14, 13, 12, 3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12);
+    const __m256i idx = _mm256_setr_epi32(0, 5, 10, 15, 20, 25, 30, 35);
+    const __m256i zchr = _mm256_set1_epi8('z');
+    const __m256i lo8 = _mm256_set1_epi32(0xff);
+    const __m256i k85 = _mm256_set1_epi32(85);
+    const __m256i k33 = _mm256_set1_epi32(33);
+    uint8_t*      d = *dst;
+    size_t        s;
+
+    /* Gather reads 3 bytes beyond each character. */
+    for (s = 0; s + 43 <= src_len && dst_cap >= 32; s += 40, dst_cap -= 32) {
+        __m256i a = _mm256_loadu_si256((const __m256i*)(src + s));
+        __m256i b = _mm256_loadu_si256((const __m256i*)(src + s + 8));
+        if (_mm256_movemask_epi8(_mm256_or_si256(
+                _mm256_cmpeq_epi8(a, zchr), _mm256_cmpeq_epi8(b, zchr)))) {
+            break;
+        }
+        __m256i x = _mm256_setzero_si256();
+        for (int i = 0; i < 5; i++) {
+            __m256i c = _mm256_and_si256(
+                _mm256_i32gather_epi32((const int*)(src + s + i), idx, 1), lo8);
+            x = _mm256_add_epi32(
+                _mm256_mullo_epi32(x, k85), _mm256_sub_epi32(c, k33));
+        }
+        _mm256_storeu_si256((__m256i*)d, _mm256_shuffle_epi8(x, bswap));
+        d += 32;
+    }
+    *dst = d;
+    return s;
+}
+
+
+__attribute__((target("sse4.1"))) static size_t _decode_blocks_sse41(
+    const char* src, size_t src_len, uint8_t** dst, size_t dst_cap)
+{
+    const __m128i bswap =
+        _mm_setr_epi8(3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12);
+    const __m128i zchr = _mm_set1_epi8('z');
+    const __m128i k85 = _mm_set1_epi32(85);
+    const __m128i k33 = _mm_set1_epi32(33);
+    uint8_t*      d = *dst;
+    size_t        s;
+
+    for (s = 0; s + 20 <= src_len && dst_cap >= 16; s += 20, dst_cap -= 16) {
+        const uint8_t* p = (const uint8_t*)src + s;
+        __m128i        a = _mm_loadu_si128((const __m128i*)p);
+        __m128i        b = _mm_loadu_si128((const __m128i*)(p + 4));
+        if (_mm_movemask_epi8(_mm_or_si128(
+                _mm_cmpeq_epi8(a, zchr), _mm_cmpeq_epi8(b, zchr)))) {
+            break;
+        }
+        __m128i x = _mm_setzero_si128();
+        for (int i = 0; i < 5; i++) {
+            __m128i c = _mm_setr_epi32(p[i], p[5 + i], p[10 + i], p[15 + i]);
+            x = _mm_add_epi32(_mm_mullo_epi32(x, k85), _mm_sub_epi32(c, k33));
+        }
+        _mm_storeu_si128((__m128i*)d, _mm_shuffle_epi8(x, bswap));
+        d += 16;
+    }
+    *dst = d;
+    return s;
+}
+
+#endif /* ASCII85_X86 */
+
+
+/* Encode full groups, zero groups are encoded as 'z'. */
+static int64_t _encode_groups(
+    const uint8_t* source, size_t groups, char* dst, size_t dst_cap)
+{
+    char*    d = dst;
+    char*    d_end = dst + dst_cap;
+    size_t   g = 0;
+    uint32_t x;
+
+    if (dst_cap >= groups * 5 + 3) {
+#if defined(ASCII85_X86)
+        /* The additional 3 bytes of capacity cover the overlapping writes of
+           the vector encoders. */
+        switch (_isa()) {
+        case ASCII85_ISA_AVX2:
+            g = _encode_blocks_avx2(source, groups, &d);
+            break;
+        case ASCII85_ISA_SSE41:
+            g = _encode_blocks_sse41(source, groups, &d);
+            break;
+        default:
+            break;
+        }
+#endif
+        for (; g < groups; g++) {
+            x = _load_group(source + g * 4);
+            if (x == 0) {
+                *d++ = 'z';
+            } else {
+                _encode_group(x, d);
+                d += 5;
+            }
+        }
+    } else {
+        for (; g < groups; g++) {
+            x = _load_group(source + g * 4);
+            if (x == 0) {
+                if (d_end - d < 1) return -EMSGSIZE;
+                *d++ = 'z';
+            } else {
+                if (d_end - d < 5) return -EMSGSIZE;
+                _encode_group(x, d);
+                d += 5;
+            }
+        }
+    }
+    return d - dst;
+}
+
+
+/* Decode full groups (and 'z'), a trailing partial group is not decoded.
+   The number of source characters consumed is returned via `consumed`. */
+static int64_t _decode_groups(const char* source, size_t source_len,
+    uint8_t* dst, size_t dst_cap, size_t* consumed)
+{
+    const char* s = source;
+    const char* s_end = source + source_len;
+    uint8_t*    d = dst;
+    uint8_t*    d_end = dst + dst_cap;
+#if defined(ASCII85_X86)
+    int         isa = _isa();
+#endif
+
+    while (s < s_end) {
+#if defined(ASCII85_X86)
+        if (isa == ASCII85_ISA_AVX2) {
+            s += _decode_blocks_avx2(s, s_end - s, &d, d_end - d);
+        } else if (isa == ASCII85_ISA_SSE41) {
+            s += _decode_blocks_sse41(s, s_end - s, &d, d_end - d);
+        }
+        if (s >= s_end) break;
+#endif
+        uint32_t x = 0;
+        if (*s == 'z') {
+            s += 1;
+        } else if (s_end - s >= 5) {
+            for (int i = 0; i < 5; i++) {
+                x = x * 85 + (uint8_t)s[i] - 33;
+            }
+            s += 5;
+        } else {
+            break;
+        }
+        if (d_end - d < 4) return -EMSGSIZE;
+        for (int i = 0; i < 4; i++) {
+            d[i] = x >> (24 - i * 8);
+        }
+        d += 4;
+    }
+
+    *consumed = s - source;
+    return d - dst;
+}
+
+
+/* Decode a partial group (2 to 4 characters, padded with 'u'). */
+static int64_t _decode_partial(
+    const char* source, size_t source_len, uint8_t* dst, size_t dst_cap)
+{
+    if (source_len == 0) return 0;
+    uint32_t x = 0;
+    for (size_t i = 0; i < 5; i++) {
+        x = x * 85 + (i < source_len ? (uint8_t)source[i] : 'u') - 33;
+    }
+    size_t n = source_len - 1;
+    if (dst_cap < n) return -EMSGSIZE;
+    for (size_t i = 0; i < n; i++) {
+        dst[i] = x >> (24 - i * 8);
+    }
+    return n;
+}
+
+
+/**
+ *  ascii85_encode_len
+ *
+ *  Calculate the (maximum) length of an ASCII85 encoding.
+ *
+ *  Parameters
+ *  ----------
+ *  source_len : size_t
+ *      The length of the binary source string.
+ *
+ *  Returns
+ *  -------
+ *      size_t : Maximum length of the encoded string (excluding null
+ *               terminator).
+ */
+size_t ascii85_encode_len(size_t source_len)
+{
+    size_t rem = source_len % 4;
+    return source_len / 4 * 5 + (rem ? rem + 1 : 0);
+}
+
+
+/**
+ *  ascii85_decode_len
+ *
+ *  Calculate the length of a decoded ASCII85 string.
+ *
+ *  Parameters
+ *  ----------
+ *  source : const char*
+ *      The ASCII85 string.
+ *
+ *  source_len : size_t
+ *      The length of the ASCII85 string.
+ *
+ *  Returns
+ *  -------
+ *      size_t : Length of the decoded binary string.
+ */
+size_t ascii85_decode_len(const char* source, size_t source_len)
+{
+    size_t      z_count = 0;
+    const char* p = source;
+    const char* end = source + source_len;
+    while ((p = memchr(p, 'z', end - p)) != NULL) {
+        z_count++;
+        p++;
+    }
+    size_t chars = source_len - z_count;
+    size_t rem = chars % 5;
+    return z_count * 4 + chars / 5 * 4 + (rem ? rem - 1 : 0);
+}
+
+
+/**
+ *  ascii85_encode_into
+ *
+ *  Encode a binary string with ASCII85 encoding into a caller provided
+ *  buffer. The encoded string is null-terminated if the buffer has capacity
+ *  for the terminator.
+ *
+ *  Parameters
+ *  ----------
+ *  source : const uint8_t*
+ *      The binary string to be encoded.
+ *
+ *  source_len : size_t
+ *      The length of the binary source string.
+ *
+ *  dst : char*
+ *      Buffer which receives the encoded string.
+ *
+ *  dst_cap : size_t
+ *      Capacity of the buffer (see `ascii85_encode_len()`).
+ *
+ *  Returns
+ *  -------
+ *      int64_t : Length of the encoded string (excluding null terminator).
+ *      -EMSGSIZE : The buffer capacity is insufficient.
+ */
+int64_t ascii85_encode_into(
+    const uint8_t* source, size_t source_len, char* dst, size_t dst_cap)
+{
+    size_t groups = source_len / 4;
+    size_t rem = source_len % 4;
+    /* Zero groups are encoded as 'z' only when followed by 4 (or more) bytes,
+       that is, all full groups except the last full group. */
+    int64_t len = _encode_groups(source, groups ? groups - 1 : 0, dst, dst_cap);
+    if (len < 0) return len;
+
+    char* d = dst + len;
+    char* d_end = dst + dst_cap;
+    /* Last full group. */
+    if (groups) {
+        if (d_end - d < 5) return -EMSGSIZE;
+        _encode_group(_load_group(source + (groups - 1) * 4), d);
+        d += 5;
+    }
+    /* Partial group (zero padded), the padded characters are removed. */
+    if (rem) {
+        uint8_t last[4] = { 0 };
+        char    encoded[5];
+        memcpy(last, source + groups * 4, rem);
+        if ((size_t)(d_end - d) < rem + 1) return -EMSGSIZE;
+        _encode_group(_load_group(last), encoded);
+        memcpy(d, encoded, rem + 1);
+        d += rem + 1;
+    }
+
+    if (d < d_end) *d = '\0';
+    return d - dst;
+}
+
+
+/**
+ *  ascii85_decode_into
+ *
+ *  Decode an ASCII85 encoded string into a caller provided buffer.
+ *
+ *  Parameters
+ *  ----------
+ *  source : const char*
+ *      The ASCII85 string to be decoded.
+ *
+ *  source_len : size_t
+ *      The length of the ASCII85 string.
+ *
+ *  dst : uint8_t*
+ *      Buffer which receives the decoded binary string.
+ *
+ *  dst_cap : size_t
+ *      Capacity of the buffer (see `ascii85_decode_len()`).
+ *
+ *  Returns
+ *  -------
+ *      int64_t : Length of the decoded binary string.
+ *      -EMSGSIZE : The buffer capacity is insufficient.
+ */
+int64_t ascii85_decode_into(
+    const char* source, size_t source_len, uint8_t* dst, size_t dst_cap)
+{
+    size_t  consumed;
+    int64_t len = _decode_groups(source, source_len, dst, dst_cap, &consumed);
+    if (len < 0) return len;
+    int64_t rc = _decode_partial(source + consumed, source_len - consumed,
+        dst + len, dst_cap - len);
+    if (rc < 0) return rc;
+    return len + rc;
+}
 
 
 /**
@@ -28,39 +531,14 @@
  */
 char* ascii85_encode(const char* source, size_t source_len)
 {
-    int required = (source_len + 3) / 4 * 5;
-    int padding = (source_len % 4) ? 4 - (source_len % 4) : 0;
+    size_t required = ascii85_encode_len(source_len);
 
     /* Encode the source. */
     char* en = calloc(required + 1, sizeof(char));
-    char* en_save = en;
-    while (source_len) {
-        uint32_t x = 0;
-        for (int chunk = 3; chunk >= 0; chunk--) {
-            x |= (uint8_t)*source << (chunk * 8);
-            source++;
-            /* Stop chunking if no more characters are available. */
-            if (--source_len == 0) break;
-        }
-        /* Special Case zero. */
-        if (x == 0 && source_len >= 4) {
-            en[0] = 'z';
-            en += 1;
-            continue;
-        }
-        for (int byte = 4; byte >= 0; byte--) {
-            en[byte] = (x % 85) + 33;
-            x /= 85;
-        }
-        en += 5;
-    }
+    if (en == NULL) return NULL;
+    ascii85_encode_into((const uint8_t*)source, source_len, en, required + 1);
 
-    /* Remove (essentially) the padded characters. */
-    for (int i = 1; i <= padding; i++) {
-        en_save[strlen(en_save) - 1] = '\0';
-    }
-
-    return en_save;
+    return en;
 }
 
 
@@ -83,55 +561,239 @@ char* ascii85_encode(const char* source, size_t source_len)
  */
 char* ascii85_decode(const char* source, size_t* len)
 {
-    /*
-    Decode is 5 -> 4, or 1 -> 4 for 'z' case. Calculate parameters with
-    necessary corrections.
-    */
-    int z_count = 0;
-    for (const char* p = source; *p; p++) {
-        if (*p == 'z') z_count++;
-    }
-    int required = (strlen(source) - z_count + 4) / 5 * 4 + z_count * 4;
-    int source_len = strlen(source) + z_count * 4;
-    int padding = (source_len % 5) ? (5 - (source_len % 5)) : 0;
-
-    /* Pad the source string. */
-    int   padded_len = strlen(source) + padding;
-    char* source_padded = calloc(padded_len + 1, sizeof(char));
-    snprintf(source_padded, padded_len + 1, "%s", source);
-    for (int i = 0; i < padding; i++) {
-        source_padded[strlen(source) + i] = 'u';
-    }
+    size_t source_len = strlen(source);
+    size_t required = ascii85_decode_len(source, source_len);
 
     /* Decode the source. */
     char* en = calloc(required + 1, sizeof(char));
-    char* en_walker = en;
-    char* src_walker = source_padded;
-    while (padded_len > 0) {
-        uint32_t x = 0;
-        if (src_walker[0] == 'z') {
-            padded_len--;
-            src_walker += 1;
-        } else {
-            for (int chunk = 0; chunk <= 4; chunk++) {
-                x = x * 85 + (src_walker[chunk] - 33);
-                padded_len--;
-            }
-            src_walker += 5;
-        }
-        for (int byte = 3; byte >= 0; byte--) {
-            *en_walker = x >> (byte * 8);
-            en_walker++;
+    if (en == NULL) return NULL;
+    int64_t rc =
+        ascii85_decode_into(source, source_len, (uint8_t*)en, required + 1);
+
+    /* Return the decoded binary string, and length. */
+    *len = (rc < 0) ? 0 : (size_t)rc;
+    return en;
+}
+
+
+/**
+ *  ascii85_encoder_init
+ *
+ *  Initialise a streaming ASCII85 encoder. The encoder holds back (up to 7)
+ *  bytes between calls, so that the encoded output is identical to that of
+ *  `ascii85_encode()` for the concatenated input.
+ *
+ *  Parameters
+ *  ----------
+ *  encoder : Ascii85Encoder*
+ *      The encoder object.
+ */
+void ascii85_encoder_init(Ascii85Encoder* encoder)
+{
+    memset(encoder, 0, sizeof(Ascii85Encoder));
+}
+
+
+/**
+ *  ascii85_encoder_update
+ *
+ *  Encode a chunk of a binary string. The encoded string is NOT
+ *  null-terminated.
+ *
+ *  Parameters
+ *  ----------
+ *  encoder : Ascii85Encoder*
+ *      The encoder object.
+ *
+ *  source : const uint8_t*
+ *      The binary string chunk to be encoded.
+ *
+ *  source_len : size_t
+ *      The length of the binary string chunk.
+ *
+ *  dst : char*
+ *      Buffer which receives the encoded string.
+ *
+ *  dst_cap : size_t
+ *      Capacity of the buffer, at least `ascii85_encode_len(source_len + 7)`.
+ *
+ *  Returns
+ *  -------
+ *      int64_t : Length of the encoded string.
+ *      -EMSGSIZE : The buffer capacity is insufficient (nothing was encoded).
+ */
+int64_t ascii85_encoder_update(Ascii85Encoder* encoder, const uint8_t* source,
+    size_t source_len, char* dst, size_t dst_cap)
+{
+    if (source_len == 0) return 0;
+    if (dst_cap < (encoder->len + source_len) / 4 * 5) return -EMSGSIZE;
+
+    char* d = dst;
+    /* Complete the held back bytes, a group is encoded when followed by 4
+       (or more) bytes. */
+    if (encoder->len) {
+        size_t n = 8 - encoder->len;
+        if (n > source_len) n = source_len;
+        memcpy(encoder->buffer + encoder->len, source, n);
+        encoder->len += n;
+        source += n;
+        source_len -= n;
+        if (encoder->len < 8) return 0;
+        d += _encode_groups(encoder->buffer, 1, d, dst_cap);
+        if (source_len < 4) {
+            memmove(encoder->buffer, encoder->buffer + 4, 4);
+            memcpy(encoder->buffer + 4, source, source_len);
+            encoder->len = 4 + source_len;
+            return d - dst;
         }
+        d += _encode_groups(encoder->buffer + 4, 1, d, dst_cap - (d - dst));
+        encoder->len = 0;
     }
-    free(source_padded);
+    /* Encode the remaining full groups, except the last 4 (or more) bytes. */
+    size_t groups = (source_len >= 8) ? (source_len - 4) / 4 : 0;
+    int64_t len = _encode_groups(source, groups, d, dst_cap - (d - dst));
+    if (len < 0) return len;
+    d += len;
+    encoder->len = source_len - groups * 4;
+    memcpy(encoder->buffer, source + groups * 4, encoder->len);
+
+    return d - dst;
+}
+
+
+/**
+ *  ascii85_encoder_final
+ *
+ *  Encode the bytes held back by the encoder. The encoded string is
+ *  null-terminated if the buffer has capacity for the terminator.
+ *
+ *  Parameters
+ *  ----------
+ *  encoder : Ascii85Encoder*
+ *      The encoder object.
+ *
+ *  dst : char*
+ *      Buffer which receives the encoded string.
+ *
+ *  dst_cap : size_t
+ *      Capacity of the buffer, at least 10 (`ascii85_encode_len(7)`).
+ *
+ *  Returns
+ *  -------
+ *      int64_t : Length of the encoded string (excluding null terminator).
+ *      -EMSGSIZE : The buffer capacity is insufficient.
+ */
+int64_t ascii85_encoder_final(Ascii85Encoder* encoder, char* dst, size_t dst_cap)
+{
+    int64_t len =
+        ascii85_encode_into(encoder->buffer, encoder->len, dst, dst_cap);
+    if (len >= 0) encoder->len = 0;
+    return len;
+}
+
+
+/**
+ *  ascii85_decoder_init
+ *
+ *  Initialise a streaming ASCII85 decoder. The decoder holds back (up to 4)
+ *  characters of a partial group between calls.
+ *
+ *  Parameters
+ *  ----------
+ *  decoder : Ascii85Decoder*
+ *      The decoder object.
+ */
+void ascii85_decoder_init(Ascii85Decoder* decoder)
+{
+    memset(decoder, 0, sizeof(Ascii85Decoder));
+}
+
 
-    /* Correct the padding. */
-    for (int i = 1; i <= padding; i++) {
-        en[required - i] = '\0';
+/**
+ *  ascii85_decoder_update
+ *
+ *  Decode a chunk of an ASCII85 encoded string.
+ *
+ *  Parameters
+ *  ----------
+ *  decoder : Ascii85Decoder*
+ *      The decoder object.
+ *
+ *  source : const char*
+ *      The ASCII85 string chunk to be decoded.
+ *
+ *  source_len : size_t
+ *      The length of the ASCII85 string chunk.
+ *
+ *  dst : uint8_t*
+ *      Buffer which receives the decoded binary string.
+ *
+ *  dst_cap : size_t
+ *      Capacity of the buffer, at least `ascii85_decode_len(source,
+ *      source_len) + 4`.
+ *
+ *  Returns
+ *  -------
+ *      int64_t : Length of the decoded binary string.
+ *      -EMSGSIZE : The buffer capacity is insufficient (nothing was decoded).
+ */
+int64_t ascii85_decoder_update(Ascii85Decoder* decoder, const char* source,
+    size_t source_len, uint8_t* dst, size_t dst_cap)
+{
+    if (source_len == 0) return 0;
+    if (dst_cap < ascii85_decode_len(source, source_len) + 4) return -EMSGSIZE;
+
+    uint8_t* d = dst;
+    size_t   consumed;
+    /* Complete the held back (partial) group. */
+    if (decoder->len) {
+        size_t n = 5 - decoder->len;
+        if (n > source_len) n = source_len;
+        memcpy(decoder->buffer + decoder->len, source, n);
+        decoder->len += n;
+        source += n;
+        source_len -= n;
+        if (decoder->len < 5) return 0;
+        d += _decode_groups(decoder->buffer, 5, d, dst_cap, &consumed);
+        decoder->len = 0;
     }
+    /* Decode the remaining full groups, hold back a partial group. */
+    int64_t len = _decode_groups(
+        source, source_len, d, dst_cap - (d - dst), &consumed);
+    if (len < 0) return len;
+    d += len;
+    decoder->len = source_len - consumed;
+    memcpy(decoder->buffer, source + consumed, decoder->len);
 
-    /* Return the decoded binary string, and length. */
-    *len = required - padding;
-    return en;
+    return d - dst;
+}
+
+
+/**
+ *  ascii85_decoder_final
+ *
+ *  Decode the (partial group) characters held back by the decoder.
+ *
+ *  Parameters
+ *  ----------
+ *  decoder : Ascii85Decoder*
+ *      The decoder object.
+ *
+ *  dst : uint8_t*
+ *      Buffer which receives the decoded binary string.
+ *
+ *  dst_cap : size_t
+ *      Capacity of the buffer, at least 3.
+ *
+ *  Returns
+ *  -------
+ *      int64_t : Length of the decoded binary string.
+ *      -EMSGSIZE : The buffer capacity is insufficient.
+ */
+int64_t ascii85_decoder_final(
+    Ascii85Decoder* decoder, uint8_t* dst, size_t dst_cap)
+{
+    int64_t len = _decode_partial(decoder->buffer, decoder->len, dst, dst_cap);
+    if (len >= 0) decoder->len = 0;
+    return len;
 }
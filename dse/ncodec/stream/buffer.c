@@ -8,21 +8,46 @@
 #include <dse/platform.h>
 #include <dse/ncodec/codec.h>
 
-#define UNUSED(x) ((void)x)
+#define UNUSED(x)           ((void)x)
+#define BUFFER_MIN_CAPACITY 256
 
 
 /* Declare an extension to the NCodecStreamVTable type. */
 typedef struct __stream {
-    NCodecStreamVTable s;
+    NCodecStreamVTable    s;
+    NCodecStreamExtVTable ext;
 
     uint8_t* buffer;
     size_t   buffer_len;
     size_t   len;
     size_t   pos;
     bool     resizable;
+    size_t   max_len;
+    size_t   hwm_len;
 } __stream;
 
 
+/* Ensure the buffer capacity is at least `size`. Resizable buffers grow
+   geometrically (limited by `max_len`, if set). */
+static int32_t _buffer_grow(__stream* _s, size_t size)
+{
+    if (size <= _s->buffer_len) return 0;
+    if (_s->resizable == false) return -EMSGSIZE;
+    if (_s->max_len && size > _s->max_len) return -EMSGSIZE;
+
+    size_t capacity = _s->buffer_len ? _s->buffer_len : BUFFER_MIN_CAPACITY;
+    while (capacity < size)
+        capacity *= 2;
+    if (_s->max_len && capacity > _s->max_len) capacity = _s->max_len;
+
+    uint8_t* buffer = realloc(_s->buffer, capacity);
+    if (buffer == NULL) return -ENOMEM;
+    _s->buffer = buffer;
+    _s->buffer_len = capacity;
+    return 0;
+}
+
+
 DLL_PRIVATE size_t stream_read(
     NCODEC* nc, uint8_t** data, size_t* len, int32_t pos_op)
 {
@@ -53,16 +78,44 @@ DLL_PRIVATE size_t stream_write(NCODEC* nc, uint8_t* data, size_t len)
 
     __stream* _s = (__stream*)_nc->stream;
 
-    if ((_s->pos + len) > _s->buffer_len) {
-        if (_s->resizable) {
-            _s->buffer = realloc(_s->buffer, _s->pos + len);
-        } else {
-            return -EMSGSIZE;
-        }
-    }
+    int32_t rc = _buffer_grow(_s, _s->pos + len);
+    if (rc < 0) return rc;
     memcpy(&_s->buffer[_s->pos], data, len);
     _s->pos += len;
     if (_s->pos > _s->len) _s->len = _s->pos;
+    if (_s->len > _s->hwm_len) _s->hwm_len = _s->len;
+    return len;
+}
+
+DLL_PRIVATE int32_t stream_reserve(NCODEC* nc, size_t len, uint8_t** data)
+{
+    NCodecInstance* _nc = (NCodecInstance*)nc;
+    if (_nc == NULL || _nc->stream == NULL) return -ENOSTR;
+    if (data == NULL) return -EINVAL;
+
+    __stream* _s = (__stream*)_nc->stream;
+
+    int32_t rc = _buffer_grow(_s, _s->pos + len);
+    if (rc < 0) {
+        *data = NULL;
+        return rc;
+    }
+    /* Return buffer, from current pos. */
+    *data = &_s->buffer[_s->pos];
+    return 0;
+}
+
+DLL_PRIVATE int32_t stream_commit(NCODEC* nc, size_t len)
+{
+    NCodecInstance* _nc = (NCodecInstance*)nc;
+    if (_nc == NULL || _nc->stream == NULL) return -ENOSTR;
+
+    __stream* _s = (__stream*)_nc->stream;
+
+    if ((_s->pos + len) > _s->buffer_len) return -EINVAL;
+    _s->pos += len;
+    if (_s->pos > _s->len) _s->len = _s->pos;
+    if (_s->len > _s->hwm_len) _s->hwm_len = _s->len;
     return len;
 }
 
@@ -147,6 +200,12 @@ void* ncodec_buffer_stream_create(size_t buffer_size)
                 .eof = stream_eof,
                 .close = stream_close,
             },
+        .ext =
+            (struct NCodecStreamExtVTable){
+                .size = sizeof(NCodecStreamExtVTable),
+                .reserve = stream_reserve,
+                .commit = stream_commit,
+            },
         .len = 0,
         .pos = 0,
     };
@@ -162,3 +221,175 @@ void* ncodec_buffer_stream_create(size_t buffer_size)
 
     return stream;
 }
+
+
+/**
+ncodec_stream_ext
+=================
+
+Get the stream extension interface of a stream created by this library
+(buffer, ring, shm or file stream). The integrator sets the extension on the
+Network Codec (`NCodecInstance.stream_ext`) when opening a codec, only then
+does the codec use the extension (i.e. to write directly into stream memory).
+
+> Note: Only call this function with streams created by this library.
+
+Parameters
+----------
+stream (void*)
+: A stream object created by this library.
+
+Returns
+-------
+NCodecStreamExtVTable* (void*)
+: The stream extension interface of the stream.
+
+NULL
+: The stream object was NULL.
+*/
+void* ncodec_stream_ext(void* stream)
+{
+    /* All streams of this library start with the stream interface followed
+       by the stream extension interface. */
+    __stream* _s = (__stream*)stream;
+    if (_s == NULL) return NULL;
+    return &_s->ext;
+}
+
+
+/**
+ncodec_buffer_stream_reserve
+============================
+
+Reserve (pre-allocate) capacity of a resizable buffer stream, for instance
+based on the high-water mark of a previous simulation step.
+
+Parameters
+----------
+stream (void*)
+: A buffer stream object (created by `ncodec_buffer_stream_create()`).
+
+size (size_t)
+: The required capacity of the buffer stream.
+
+Returns
+-------
+0 (int32_t)
+: The buffer stream has (at least) the requested capacity.
+
+-EMSGSIZE (-90)
+: The requested capacity exceeds the (maximum) size of the buffer stream.
+
+-ENOMEM (-12)
+: The capacity could not be allocated.
+*/
+int32_t ncodec_buffer_stream_reserve(void* stream, size_t size)
+{
+    __stream* _s = (__stream*)stream;
+    if (_s == NULL) return -ENOSTR;
+    if (size <= _s->buffer_len) return 0;
+    if (_s->resizable == false) return -EMSGSIZE;
+    if (_s->max_len && size > _s->max_len) return -EMSGSIZE;
+
+    uint8_t* buffer = realloc(_s->buffer, size);
+    if (buffer == NULL) return -ENOMEM;
+    _s->buffer = buffer;
+    _s->buffer_len = size;
+    return 0;
+}
+
+
+/**
+ncodec_buffer_stream_shrink_to_fit
+==================================
+
+Release unused capacity of a resizable buffer stream. Typically called after
+the stream is truncated (i.e. `ncodec_truncate()`), in which case all
+capacity is released.
+
+Parameters
+----------
+stream (void*)
+: A buffer stream object (created by `ncodec_buffer_stream_create()`).
+
+Returns
+-------
+size_t
+: The capacity of the buffer stream.
+*/
+size_t ncodec_buffer_stream_shrink_to_fit(void* stream)
+{
+    __stream* _s = (__stream*)stream;
+    if (_s == NULL) return 0;
+    if (_s->resizable == false) return _s->buffer_len;
+    if (_s->len == _s->buffer_len) return _s->buffer_len;
+
+    if (_s->len == 0) {
+        free(_s->buffer);
+        _s->buffer = NULL;
+    } else {
+        uint8_t* buffer = realloc(_s->buffer, _s->len);
+        if (buffer == NULL) return _s->buffer_len;
+        _s->buffer = buffer;
+    }
+    _s->buffer_len = _s->len;
+    return _s->buffer_len;
+}
+
+
+/**
+ncodec_buffer_stream_set_max
+============================
+
+Set the maximum capacity of a resizable buffer stream. Writes which would
+grow the buffer stream beyond this capacity fail with -EMSGSIZE.
+
+Parameters
+----------
+stream (void*)
+: A buffer stream object (created by `ncodec_buffer_stream_create()`).
+
+max_size (size_t)
+: The maximum capacity of the buffer stream, 0 for unlimited.
+
+Returns
+-------
+0 (int32_t)
+: The maximum capacity was set.
+
+-EINVAL (-22)
+: The buffer stream is not resizable, or already exceeds `max_size`.
+*/
+int32_t ncodec_buffer_stream_set_max(void* stream, size_t max_size)
+{
+    __stream* _s = (__stream*)stream;
+    if (_s == NULL) return -ENOSTR;
+    if (_s->resizable == false) return -EINVAL;
+    if (max_size && _s->buffer_len > max_size) return -EINVAL;
+
+    _s->max_len = max_size;
+    return 0;
+}
+
+
+/**
+ncodec_buffer_stream_hwm
+========================
+
+Parameters
+----------
+stream (void*)
+: A buffer stream object (created by `ncodec_buffer_stream_create()`).
+
+Returns
+-------
+size_t
+: The high-water mark of the buffer stream, i.e. the largest length of
+  stream content since the buffer stream was created.
+*/
+size_t ncodec_buffer_stream_hwm(void* stream)
+{
+    __stream* _s = (__stream*)stream;
+    if (_s == NULL) return 0;
+    return _s->hwm_len;
+}
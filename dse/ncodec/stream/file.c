@@ -0,0 +1,329 @@
+// Copyright 2025 Robert Bosch GmbH
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE /* mremap() */
+#endif
+#include <errno.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <dse/platform.h>
+#include <dse/ncodec/codec.h>
+
+#define UNUSED(x)         ((void)x)
+#define FILE_STREAM_CHUNK (1 << 20) /* 1 MiB. */
+
+/* Address range reserved for the mapping of a writable stream. */
+#if UINTPTR_MAX > 0xFFFFFFFFu
+#define FILE_STREAM_RESERVE ((size_t)1 << 34) /* 16 GiB. */
+#else
+#define FILE_STREAM_RESERVE ((size_t)1 << 28) /* 256 MiB. */
+#endif
+
+
+/* Declare an extension to the NCodecStreamVTable type. */
+typedef struct __file_stream {
+    NCodecStreamVTable    s;
+    NCodecStreamExtVTable ext;
+
+    int      fd;
+    bool     writable;
+    uint8_t* buffer;
+    size_t   buffer_len; /* Usable length (and file size, when writable). */
+    size_t   map_len;    /* Mapped length (reserved address range). */
+    size_t   len;
+    size_t   pos;
+    size_t   base; /* Start of the stream window (see NCODEC_SEEK_RESET). */
+} __file_stream;
+
+
+/* Grow the file so that at least `size` bytes are available. The file grows
+   in chunks (at least FILE_STREAM_CHUNK, or half the current size) and is
+   truncated to the content length when the stream is closed. The file is
+   mapped into a reserved address range, so that pointers into the stream stay
+   valid as the file grows; only when the file exceeds that range is the
+   mapping extended (and possibly moved). */
+static int32_t _file_grow(__file_stream* _s, size_t size)
+{
+    if (size <= _s->buffer_len) return 0;
+
+    size_t step = _s->buffer_len / 2;
+    if (step < FILE_STREAM_CHUNK) step = FILE_STREAM_CHUNK;
+    size_t capacity = _s->buffer_len + step;
+    if (capacity < size) capacity = size;
+    capacity = (capacity + FILE_STREAM_CHUNK - 1) / FILE_STREAM_CHUNK *
+               FILE_STREAM_CHUNK;
+
+    if (ftruncate(_s->fd, capacity) < 0) return -errno;
+    if (capacity > _s->map_len) {
+        void* buffer;
+        if (_s->buffer) {
+            buffer = mremap(_s->buffer, _s->map_len, capacity, MREMAP_MAYMOVE);
+        } else {
+            buffer = mmap(NULL, capacity, PROT_READ | PROT_WRITE, MAP_SHARED,
+                _s->fd, 0);
+        }
+        if (buffer == MAP_FAILED) return -ENOMEM;
+        _s->buffer = buffer;
+        _s->map_len = capacity;
+    }
+    _s->buffer_len = capacity;
+    return 0;
+}
+
+
+static size_t file_stream_read(
+    NCODEC* nc, uint8_t** data, size_t* len, int32_t pos_op)
+{
+    NCodecInstance* _nc = (NCodecInstance*)nc;
+    if (_nc == NULL || _nc->stream == NULL) return -ENOSTR;
+    if (data == NULL || len == NULL) return -EINVAL;
+
+    __file_stream* _s = (__file_stream*)_nc->stream;
+    /* Check EOF. */
+    if (_s->pos >= _s->len) {
+        *data = NULL;
+        *len = 0;
+        return 0;
+    }
+    /* Return buffer (mapped file), from current pos. */
+    *data = &_s->buffer[_s->pos];
+    *len = _s->len - _s->pos;
+    /* Advance the position indicator. */
+    if (pos_op == NCODEC_POS_UPDATE) _s->pos = _s->len;
+
+    return *len;
+}
+
+static int32_t file_stream_reserve(NCODEC* nc, size_t len, uint8_t** data)
+{
+    NCodecInstance* _nc = (NCodecInstance*)nc;
+    if (_nc == NULL || _nc->stream == NULL) return -ENOSTR;
+    if (data == NULL) return -EINVAL;
+
+    __file_stream* _s = (__file_stream*)_nc->stream;
+    *data = NULL;
+    if (_s->writable == false) return -EPERM;
+    int32_t rc = _file_grow(_s, _s->pos + len);
+    if (rc < 0) return rc;
+    *data = &_s->buffer[_s->pos];
+    return 0;
+}
+
+static int32_t file_stream_commit(NCODEC* nc, size_t len)
+{
+    NCodecInstance* _nc = (NCodecInstance*)nc;
+    if (_nc == NULL || _nc->stream == NULL) return -ENOSTR;
+
+    __file_stream* _s = (__file_stream*)_nc->stream;
+    if (_s->writable == false) return -EPERM;
+    if ((_s->pos + len) > _s->buffer_len) return -EINVAL;
+    _s->pos += len;
+    if (_s->pos > _s->len) _s->len = _s->pos;
+    return len;
+}
+
+static size_t file_stream_write(NCODEC* nc, uint8_t* data, size_t len)
+{
+    uint8_t* ptr;
+    int32_t  rc = file_stream_reserve(nc, len, &ptr);
+    if (rc < 0) return rc;
+    memcpy(ptr, data, len);
+    return file_stream_commit(nc, len);
+}
+
+static int64_t file_stream_seek(NCODEC* nc, size_t pos, int32_t op)
+{
+    NCodecInstance* _nc = (NCodecInstance*)nc;
+    if (_nc && _nc->stream) {
+        __file_stream* _s = (__file_stream*)_nc->stream;
+        if (op == NCODEC_SEEK_SET) {
+            pos = _s->base + pos;
+            if (pos > _s->len) {
+                _s->pos = _s->len;
+            } else {
+                _s->pos = pos;
+            }
+        } else if (op == NCODEC_SEEK_CUR) {
+            pos = _s->pos + pos;
+            if (pos > _s->len) {
+                _s->pos = _s->len;
+            } else {
+                _s->pos = pos;
+            }
+        } else if (op == NCODEC_SEEK_END) {
+            _s->pos = _s->len;
+        } else if (op == NCODEC_SEEK_RESET) {
+            /* Recorded content is not truncated, when recording the stream
+               window moves to the end of the recorded content. */
+            if (_s->writable) _s->base = _s->pos = _s->len;
+        } else {
+            return -EINVAL;
+        }
+
+        return _s->pos - _s->base;
+    }
+    return -ENOSTR;
+}
+
+static int64_t file_stream_tell(NCODEC* nc)
+{
+    NCodecInstance* _nc = (NCodecInstance*)nc;
+    if (_nc && _nc->stream) {
+        __file_stream* _s = (__file_stream*)_nc->stream;
+        return _s->pos - _s->base;
+    }
+    return -ENOSTR;
+}
+
+static int32_t file_stream_eof(NCODEC* nc)
+{
+    NCodecInstance* _nc = (NCodecInstance*)nc;
+    if (_nc && _nc->stream) {
+        __file_stream* _s = (__file_stream*)_nc->stream;
+        if (_s->pos < _s->len) return 0;
+    }
+    return 1;
+}
+
+static int32_t file_stream_close(NCODEC* nc)
+{
+    NCodecInstance* _nc = (NCodecInstance*)nc;
+    if (_nc && _nc->stream) {
+        __file_stream* _s = (__file_stream*)_nc->stream;
+        if (_s->buffer) munmap(_s->buffer, _s->map_len);
+        if (_s->writable) {
+            /* Remove the unused (chunk) capacity from the file. */
+            int rc = ftruncate(_s->fd, _s->len);
+            UNUSED(rc);
+        }
+        close(_s->fd);
+        free(_nc->stream);
+        _nc->stream = NULL;
+        return 0;
+    }
+    return -ENOSTR;
+}
+
+
+/**
+ncodec_file_stream_create
+=========================
+
+Create a stream which is backed by a memory mapped file, for recording and
+replaying bus traffic. Reads return pointers into the mapped file (i.e. zero
+copy) and writes are made directly to the mapped file, which grows in large
+chunks. When the stream is closed the file is truncated to the length of the
+stream content.
+
+When recording, the file is mapped into a reserved address range (16 GiB,
+256 MiB on 32 bit platforms) and pointers returned by reads remain valid as
+the file grows. Should the recording exceed the reserved range, the mapping
+is extended and may move; pointers into the stream (e.g. messages previously
+read) are then invalid after the write which grew the file.
+
+The stream content is never truncated. When recording, `NCODEC_SEEK_RESET`
+moves the stream window to the end of the recorded content (i.e. each
+simulation step is appended to the recording), stream positions are then
+relative to the start of the window.
+
+Parameters
+----------
+path (const char*)
+: The path of the file.
+
+mode (const char*)
+: The file mode:
+  * "r" - replay, the file is mapped read only. `NCODEC_SEEK_RESET` has no
+    effect.
+  * "w" - record, the file is created (or truncated).
+  * "a" - record, the file is created (or appended).
+
+Returns
+-------
+NCodecStreamVTable* (void*)
+: A stream object, or NULL if the stream could not be created.
+*/
+void* ncodec_file_stream_create(const char* path, const char* mode)
+{
+    if (path == NULL || mode == NULL) return NULL;
+
+    int  flags;
+    bool writable = true;
+    if (strcmp(mode, "r") == 0) {
+        flags = O_RDONLY;
+        writable = false;
+    } else if (strcmp(mode, "w") == 0) {
+        flags = O_RDWR | O_CREAT | O_TRUNC;
+    } else if (strcmp(mode, "a") == 0) {
+        flags = O_RDWR | O_CREAT;
+    } else {
+        return NULL;
+    }
+    int fd = open(path, flags, 0644);
+    if (fd < 0) return NULL;
+    struct stat st;
+    if (fstat(fd, &st) < 0) {
+        close(fd);
+        return NULL;
+    }
+
+    __file_stream* stream = calloc(1, sizeof(__file_stream));
+    if (stream == NULL) {
+        close(fd);
+        return NULL;
+    }
+    *stream = (__file_stream){
+        .s =
+            (struct NCodecStreamVTable){
+                .read = file_stream_read,
+                .write = file_stream_write,
+                .seek = file_stream_seek,
+                .tell = file_stream_tell,
+                .eof = file_stream_eof,
+                .close = file_stream_close,
+            },
+        .ext =
+            (struct NCodecStreamExtVTable){
+                .size = sizeof(NCodecStreamExtVTable),
+                .reserve = file_stream_reserve,
+                .commit = file_stream_commit,
+            },
+        .fd = fd,
+        .writable = writable,
+        .len = st.st_size,
+        .pos = 0,
+    };
+
+    if (writable && (size_t)st.st_size < FILE_STREAM_RESERVE) {
+        /* Reserve the address range (the file is grown within it). */
+        void* buffer = mmap(NULL, FILE_STREAM_RESERVE, PROT_READ | PROT_WRITE,
+            MAP_SHARED, fd, 0);
+        if (buffer != MAP_FAILED) {
+            stream->buffer = buffer;
+            stream->buffer_len = st.st_size;
+            stream->map_len = FILE_STREAM_RESERVE;
+        }
+    }
+    if (stream->buffer == NULL && st.st_size) {
+        stream->buffer = mmap(NULL, st.st_size,
+            writable ? PROT_READ | PROT_WRITE : PROT_READ, MAP_SHARED, fd, 0);
+        if (stream->buffer == MAP_FAILED) {
+            close(fd);
+            free(stream);
+            return NULL;
+        }
+        stream->buffer_len = st.st_size;
+        stream->map_len = st.st_size;
+        if (!writable) madvise(stream->buffer, st.st_size, MADV_SEQUENTIAL);
+    }
+    if (strcmp(mode, "a") == 0) stream->pos = stream->len;
+
+    return stream;
+}
@@ -0,0 +1,288 @@
+// Copyright 2025 Robert Bosch GmbH
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#include <string.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <dse/platform.h>
+#include <dse/ncodec/codec.h>
+#include <dse/ncodec/stream/ring.h>
+
+#define UNUSED(x) ((void)x)
+
+#define LOAD(p)     __atomic_load_n(p, __ATOMIC_ACQUIRE)
+#define STORE(p, v) __atomic_store_n(p, v, __ATOMIC_RELEASE)
+
+
+/* Calculate the end of the readable (contiguous) region which starts at the
+   read position. Padding (at the end of the data region) is skipped. */
+static uint64_t _ring_readable(__ring_stream* _s)
+{
+    RingBuffer* r = _s->ring;
+    uint64_t    mask = r->capacity - 1;
+    uint64_t    head = LOAD(&r->head);
+    uint64_t    pad = LOAD(&r->pad_from);
+    if (_s->rd >= head) return head;
+
+    uint64_t boundary = (_s->rd | mask) + 1;
+    uint64_t end = (head < boundary) ? head : boundary;
+    if (pad != RING_NO_PAD && ((pad | mask) + 1) == boundary &&
+        head >= boundary) {
+        if (_s->rd >= pad) {
+            /* Skip the padding, continue from the start of the data. */
+            _s->rd = boundary;
+            boundary += r->capacity;
+            end = (head < boundary) ? head : boundary;
+        } else {
+            end = pad;
+        }
+    }
+    return end;
+}
+
+
+DLL_PRIVATE void ring_init(RingBuffer* ring, size_t capacity)
+{
+    ring->head = 0;
+    ring->tail = 0;
+    ring->pad_from = RING_NO_PAD;
+    ring->capacity = capacity;
+    ring->refs = 1;
+}
+
+
+DLL_PRIVATE size_t ring_stream_read(
+    NCODEC* nc, uint8_t** data, size_t* len, int32_t pos_op)
+{
+    NCodecInstance* _nc = (NCodecInstance*)nc;
+    if (_nc == NULL || _nc->stream == NULL) return -ENOSTR;
+    if (data == NULL || len == NULL) return -EINVAL;
+
+    __ring_stream* _s = (__ring_stream*)_nc->stream;
+    RingBuffer*    r = _s->ring;
+    uint64_t       end = _ring_readable(_s);
+    /* Check EOF. */
+    if (_s->rd >= end) {
+        *data = NULL;
+        *len = 0;
+        return 0;
+    }
+    /* Return buffer, from current read position. */
+    *data = &r->data[_s->rd & (r->capacity - 1)];
+    *len = end - _s->rd;
+    /* Advance the position indicator. */
+    if (pos_op == NCODEC_POS_UPDATE) _s->rd = end;
+
+    return *len;
+}
+
+DLL_PRIVATE int32_t ring_stream_reserve(NCODEC* nc, size_t len, uint8_t** data)
+{
+    NCodecInstance* _nc = (NCodecInstance*)nc;
+    if (_nc == NULL || _nc->stream == NULL) return -ENOSTR;
+    if (data == NULL) return -EINVAL;
+
+    __ring_stream* _s = (__ring_stream*)_nc->stream;
+    RingBuffer*    r = _s->ring;
+    uint64_t       head = LOAD(&r->head);
+    uint64_t       tail = LOAD(&r->tail);
+    uint64_t       offset = head & (r->capacity - 1);
+    *data = NULL;
+    if (len > r->capacity) return -EMSGSIZE;
+
+    /* Messages are contiguous, wrap (and pad) if necessary. */
+    uint64_t pos = head;
+    if (offset + len > r->capacity) pos += r->capacity - offset;
+    if (pos + len - tail > r->capacity) return -EMSGSIZE;
+
+    _s->wr = pos;
+    _s->wr_len = len;
+    *data = &r->data[pos & (r->capacity - 1)];
+    return 0;
+}
+
+DLL_PRIVATE int32_t ring_stream_commit(NCODEC* nc, size_t len)
+{
+    NCodecInstance* _nc = (NCodecInstance*)nc;
+    if (_nc == NULL || _nc->stream == NULL) return -ENOSTR;
+
+    __ring_stream* _s = (__ring_stream*)_nc->stream;
+    RingBuffer*    r = _s->ring;
+    if (len > _s->wr_len) return -EINVAL;
+
+    /* Publish the message (and padding). */
+    uint64_t head = LOAD(&r->head);
+    if (_s->wr != head) __atomic_store_n(&r->pad_from, head, __ATOMIC_RELAXED);
+    STORE(&r->head, _s->wr + len);
+    _s->wr_len = 0;
+    return len;
+}
+
+DLL_PRIVATE size_t ring_stream_write(NCODEC* nc, uint8_t* data, size_t len)
+{
+    uint8_t* ptr;
+    int32_t  rc = ring_stream_reserve(nc, len, &ptr);
+    if (rc < 0) return rc;
+    memcpy(ptr, data, len);
+    return ring_stream_commit(nc, len);
+}
+
+DLL_PRIVATE int64_t ring_stream_seek(NCODEC* nc, size_t pos, int32_t op)
+{
+    NCodecInstance* _nc = (NCodecInstance*)nc;
+    if (_nc && _nc->stream) {
+        __ring_stream* _s = (__ring_stream*)_nc->stream;
+        RingBuffer*    r = _s->ring;
+        uint64_t       head = LOAD(&r->head);
+        uint64_t       tail = LOAD(&r->tail);
+        if (op == NCODEC_SEEK_SET) {
+            _s->rd = tail + pos;
+        } else if (op == NCODEC_SEEK_CUR) {
+            _s->rd = _s->rd + pos;
+        } else if (op == NCODEC_SEEK_END) {
+            _s->rd = head;
+        } else if (op == NCODEC_SEEK_RESET) {
+            /* Release the consumed region to the writer. */
+            if (_s->rd > tail) {
+                STORE(&r->tail, _s->rd);
+                tail = _s->rd;
+            }
+        } else {
+            return -EINVAL;
+        }
+        if (_s->rd > head) _s->rd = head;
+        if (_s->rd < tail) _s->rd = tail;
+
+        return _s->rd - tail;
+    }
+    return -ENOSTR;
+}
+
+DLL_PRIVATE int64_t ring_stream_tell(NCODEC* nc)
+{
+    NCodecInstance* _nc = (NCodecInstance*)nc;
+    if (_nc && _nc->stream) {
+        __ring_stream* _s = (__ring_stream*)_nc->stream;
+        return _s->rd - LOAD(&_s->ring->tail);
+    }
+    return -ENOSTR;
+}
+
+DLL_PRIVATE int32_t ring_stream_eof(NCODEC* nc)
+{
+    NCodecInstance* _nc = (NCodecInstance*)nc;
+    if (_nc && _nc->stream) {
+        __ring_stream* _s = (__ring_stream*)_nc->stream;
+        if (_s->rd < _ring_readable(_s)) return 0;
+    }
+    return 1;
+}
+
+static int32_t ring_stream_close(NCODEC* nc)
+{
+    NCodecInstance* _nc = (NCodecInstance*)nc;
+    if (_nc && _nc->stream) {
+        __ring_stream* _s = (__ring_stream*)_nc->stream;
+        if (__atomic_sub_fetch(&_s->ring->refs, 1, __ATOMIC_ACQ_REL) == 0) {
+            free(_s->ring);
+        }
+        free(_nc->stream);
+        _nc->stream = NULL;
+        return 0;
+    }
+    return -ENOSTR;
+}
+
+
+DLL_PRIVATE void ring_stream_init(__ring_stream* stream, RingBuffer* ring)
+{
+    *stream = (__ring_stream){
+        .s =
+            (struct NCodecStreamVTable){
+                .read = ring_stream_read,
+                .write = ring_stream_write,
+                .seek = ring_stream_seek,
+                .tell = ring_stream_tell,
+                .eof = ring_stream_eof,
+                .close = ring_stream_close,
+            },
+        .ext =
+            (struct NCodecStreamExtVTable){
+                .size = sizeof(NCodecStreamExtVTable),
+                .reserve = ring_stream_reserve,
+                .commit = ring_stream_commit,
+            },
+        .ring = ring,
+        .rd = LOAD(&ring->tail),
+    };
+}
+
+
+/**
+ncodec_ring_stream_create
+=========================
+
+Create a ring buffer stream. Messages written to the stream are appended
+(the stream is not truncated/rewound), and the read side consumes messages.
+Consumed messages are released to the write side when the reader truncates
+its stream (i.e. `ncodec_truncate()`, `NCODEC_SEEK_RESET`). Writes which
+exceed the available capacity fail with -EMSGSIZE.
+
+Parameters
+----------
+capacity (size_t)
+: The capacity of the ring buffer, rounded up to a power of two.
+
+Returns
+-------
+NCodecStreamVTable* (void*)
+: A stream object, or NULL if the stream could not be created.
+*/
+void* ncodec_ring_stream_create(size_t capacity)
+{
+    if (capacity == 0) return NULL;
+
+    size_t _capacity = 1;
+    while (_capacity < capacity)
+        _capacity <<= 1;
+    RingBuffer* ring = calloc(1, sizeof(RingBuffer) + _capacity);
+    if (ring == NULL) return NULL;
+    ring_init(ring, _capacity);
+
+    __ring_stream* stream = calloc(1, sizeof(__ring_stream));
+    ring_stream_init(stream, ring);
+    return stream;
+}
+
+
+/**
+ncodec_ring_stream_share
+========================
+
+Create an additional stream object for an existing ring buffer stream, so
+that a producer and consumer (i.e. each with their own Network Codec) can
+operate on the same ring buffer. Each stream object is closed separately.
+The ring buffer supports a single producer and a single consumer.
+
+Parameters
+----------
+stream (void*)
+: A ring buffer stream object (created by `ncodec_ring_stream_create()`).
+
+Returns
+-------
+NCodecStreamVTable* (void*)
+: A stream object, or NULL if the stream could not be created.
+*/
+void* ncodec_ring_stream_share(void* stream)
+{
+    __ring_stream* _s = (__ring_stream*)stream;
+    if (_s == NULL) return NULL;
+
+    __ring_stream* share = calloc(1, sizeof(__ring_stream));
+    if (share == NULL) return NULL;
+    __atomic_add_fetch(&_s->ring->refs, 1, __ATOMIC_ACQ_REL);
+    ring_stream_init(share, _s->ring);
+    return share;
+}
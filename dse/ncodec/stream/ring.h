@@ -0,0 +1,63 @@
+// Copyright 2025 Robert Bosch GmbH
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef DSE_NCODEC_STREAM_RING_H_
+#define DSE_NCODEC_STREAM_RING_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <dse/platform.h>
+#include <dse/ncodec/codec.h>
+
+
+#define RING_NO_PAD UINT64_MAX
+
+
+/* Ring buffer (control block and data), single producer single consumer.
+
+   The head (written) and tail (released) counters increase monotonically,
+   the data offset of a counter is (counter & mask). Messages are written
+   contiguously; when a message does not fit before the end of the data
+   region the remaining bytes are skipped (pad_from marks the start of the
+   skipped region). The layout is position independent, so that the ring
+   can be located in shared memory. */
+typedef struct RingBuffer {
+    uint64_t head;
+    uint64_t tail;
+    uint64_t pad_from;
+    uint64_t capacity;
+    uint32_t refs;
+    uint32_t __reserved;
+    uint8_t  data[];
+} RingBuffer;
+
+
+/* Declare an extension to the NCodecStreamVTable type. */
+typedef struct __ring_stream {
+    NCodecStreamVTable    s;
+    NCodecStreamExtVTable ext;
+
+    RingBuffer* ring;
+    /* Reader state: read position (consumed, not yet released). */
+    uint64_t    rd;
+    /* Writer state: reserved position and length. */
+    uint64_t    wr;
+    size_t      wr_len;
+} __ring_stream;
+
+
+/* ring.c */
+DLL_PRIVATE void    ring_init(RingBuffer* ring, size_t capacity);
+DLL_PRIVATE void    ring_stream_init(__ring_stream* stream, RingBuffer* ring);
+DLL_PRIVATE size_t  ring_stream_read(
+    NCODEC* nc, uint8_t** data, size_t* len, int32_t pos_op);
+DLL_PRIVATE size_t  ring_stream_write(NCODEC* nc, uint8_t* data, size_t len);
+DLL_PRIVATE int64_t ring_stream_seek(NCODEC* nc, size_t pos, int32_t op);
+DLL_PRIVATE int64_t ring_stream_tell(NCODEC* nc);
+DLL_PRIVATE int32_t ring_stream_eof(NCODEC* nc);
+DLL_PRIVATE int32_t ring_stream_reserve(NCODEC* nc, size_t len, uint8_t** data);
+DLL_PRIVATE int32_t ring_stream_commit(NCODEC* nc, size_t len);
+
+
+#endif  // DSE_NCODEC_STREAM_RING_H_
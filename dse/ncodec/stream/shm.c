@@ -0,0 +1,145 @@
+// Copyright 2025 Robert Bosch GmbH
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#include <errno.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <dse/platform.h>
+#include <dse/ncodec/codec.h>
+#include <dse/ncodec/stream/ring.h>
+
+#define UNUSED(x) ((void)x)
+
+
+/* Declare an extension to the (ring) stream type. */
+typedef struct __shm_stream {
+    __ring_stream rs;
+
+    char*  name;
+    size_t map_len;
+    bool   created;
+} __shm_stream;
+
+
+static int32_t shm_stream_close(NCODEC* nc)
+{
+    NCodecInstance* _nc = (NCodecInstance*)nc;
+    if (_nc && _nc->stream) {
+        __shm_stream* _s = (__shm_stream*)_nc->stream;
+        /* The creator of the segment removes it (connected streams retain
+           their mapping until they are closed). */
+        if (_s->created) shm_unlink(_s->name);
+        munmap(_s->rs.ring, _s->map_len);
+        free(_s->name);
+        free(_nc->stream);
+        _nc->stream = NULL;
+        return 0;
+    }
+    return -ENOSTR;
+}
+
+
+/**
+ncodec_shm_stream_create
+========================
+
+Create (or connect to) a shared memory stream. The stream is a ring buffer
+(single producer, single consumer) located in a POSIX shared memory segment,
+which allows Network Codecs in different processes to exchange messages.
+The first process creates the segment, other processes connect to the
+existing segment (with the same name). Stream semantics are the same as for
+`ncodec_ring_stream_create()`.
+
+The creating stream owns the segment: when it is closed the segment is
+removed (`shm_unlink()`), streams already connected continue to operate until
+they are closed, later calls create a new segment. If the creating process
+terminates without closing the stream the segment is not removed, later calls
+connect to that (stale) segment; remove it with `shm_unlink()` (i.e. delete
+the file in `/dev/shm`) before restarting.
+
+Parameters
+----------
+name (const char*)
+: The name of the shared memory segment (e.g. "/ncodec.can0").
+
+capacity (size_t)
+: The capacity of the ring buffer, rounded up to a power of two. Ignored when
+  connecting to an existing segment.
+
+Returns
+-------
+NCodecStreamVTable* (void*)
+: A stream object, or NULL if the stream could not be created (e.g. the
+  segment exists but is not yet initialised, retry).
+*/
+void* ncodec_shm_stream_create(const char* name, size_t capacity)
+{
+    if (name == NULL) return NULL;
+
+    bool created = true;
+    int  fd = shm_open(name, O_RDWR | O_CREAT | O_EXCL, 0600);
+    if (fd < 0 && errno == EEXIST) {
+        created = false;
+        fd = shm_open(name, O_RDWR, 0600);
+    }
+    if (fd < 0) return NULL;
+
+    size_t map_len;
+    if (created) {
+        if (capacity == 0) goto create_fail;
+        size_t _capacity = 1;
+        while (_capacity < capacity)
+            _capacity <<= 1;
+        capacity = _capacity;
+        map_len = sizeof(RingBuffer) + capacity;
+        if (ftruncate(fd, map_len) < 0) goto create_fail;
+    } else {
+        struct stat st;
+        if (fstat(fd, &st) < 0) goto create_fail;
+        if ((size_t)st.st_size <= sizeof(RingBuffer)) goto create_fail;
+        map_len = st.st_size;
+        capacity = map_len - sizeof(RingBuffer);
+    }
+
+    RingBuffer* ring =
+        mmap(NULL, map_len, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    fd = -1;
+    if (ring == MAP_FAILED) goto create_fail;
+    if (created) {
+        ring_init(ring, 0);
+        __atomic_store_n(&ring->capacity, capacity, __ATOMIC_RELEASE);
+    } else {
+        /* The ring is initialised when the capacity is set. */
+        if (__atomic_load_n(&ring->capacity, __ATOMIC_ACQUIRE) != capacity) {
+            munmap(ring, map_len);
+            return NULL;
+        }
+    }
+
+    __shm_stream* stream = calloc(1, sizeof(__shm_stream));
+    char*         _name = strdup(name);
+    if (stream == NULL || _name == NULL) {
+        free(stream);
+        free(_name);
+        munmap(ring, map_len);
+        goto create_fail;
+    }
+    ring_stream_init(&stream->rs, ring);
+    stream->rs.s.close = shm_stream_close;
+    stream->name = _name;
+    stream->map_len = map_len;
+    stream->created = created;
+    return stream;
+
+create_fail:
+    if (fd >= 0) close(fd);
+    if (created) shm_unlink(name);
+    return NULL;
+}
@@ -5,15 +5,61 @@
 #ifndef DSE_NCODEC_STREAM_STREAM_H_
 #define DSE_NCODEC_STREAM_STREAM_H_
 
+#include <stddef.h>
+#include <stdint.h>
 #include <dse/platform.h>
 
 
+typedef struct Ascii85Encoder {
+    uint8_t buffer[8];
+    size_t  len;
+} Ascii85Encoder;
+
+typedef struct Ascii85Decoder {
+    char   buffer[5];
+    size_t len;
+} Ascii85Decoder;
+
+
 /* buffer.c */
 DLL_PUBLIC void* ncodec_buffer_stream_create(size_t buffer_size);
+DLL_PUBLIC void* ncodec_stream_ext(void* stream);
+
+DLL_PUBLIC int32_t ncodec_buffer_stream_reserve(void* stream, size_t size);
+DLL_PUBLIC size_t  ncodec_buffer_stream_shrink_to_fit(void* stream);
+DLL_PUBLIC int32_t ncodec_buffer_stream_set_max(void* stream, size_t max_size);
+DLL_PUBLIC size_t  ncodec_buffer_stream_hwm(void* stream);
+
+/* ring.c */
+DLL_PUBLIC void* ncodec_ring_stream_create(size_t capacity);
+DLL_PUBLIC void* ncodec_ring_stream_share(void* stream);
+
+/* shm.c */
+DLL_PUBLIC void* ncodec_shm_stream_create(const char* name, size_t capacity);
+
+/* file.c */
+DLL_PUBLIC void* ncodec_file_stream_create(const char* path, const char* mode);
 
 /* ascii85.c */
 DLL_PUBLIC char* ascii85_encode(const char* source, size_t source_len);
 DLL_PUBLIC char* ascii85_decode(const char* source, size_t* len);
 
+DLL_PUBLIC size_t  ascii85_encode_len(size_t source_len);
+DLL_PUBLIC size_t  ascii85_decode_len(const char* source, size_t source_len);
+DLL_PUBLIC int64_t ascii85_encode_into(
+    const uint8_t* source, size_t source_len, char* dst, size_t dst_cap);
+DLL_PUBLIC int64_t ascii85_decode_into(
+    const char* source, size_t source_len, uint8_t* dst, size_t dst_cap);
+DLL_PUBLIC void    ascii85_encoder_init(Ascii85Encoder* encoder);
+DLL_PUBLIC int64_t ascii85_encoder_update(Ascii85Encoder* encoder,
+    const uint8_t* source, size_t source_len, char* dst, size_t dst_cap);
+DLL_PUBLIC int64_t ascii85_encoder_final(
+    Ascii85Encoder* encoder, char* dst, size_t dst_cap);
+DLL_PUBLIC void    ascii85_decoder_init(Ascii85Decoder* decoder);
+DLL_PUBLIC int64_t ascii85_decoder_update(Ascii85Decoder* decoder,
+    const char* source, size_t source_len, uint8_t* dst, size_t dst_cap);
+DLL_PUBLIC int64_t ascii85_decoder_final(
+    Ascii85Decoder* decoder, uint8_t* dst, size_t dst_cap);
+
 
 #endif  // DSE_NCODEC_STREAM_STREAM_H_
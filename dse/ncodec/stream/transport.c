@@ -0,0 +1,242 @@
+// Copyright 2025 Robert Bosch GmbH
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#include <errno.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdlib.h>
+#define PDIAGNOSTIC_IGNORE_UNUSED_FUNCTION
+#include <flatcc/portable/pdiagnostic_push.h>
+#include <flatcc/portable/pbase64.h>
+#include <flatcc/portable/pdiagnostic_pop.h>
+#include <dse/platform.h>
+#include <dse/ncodec/stream/stream.h>
+#include <dse/ncodec/stream/transport.h>
+
+#define UNUSED(x)   ((void)x)
+#define BASE64_MODE (base64_mode_rfc4648 | base64_enc_modifier_padding)
+
+
+/* Base64 transport (flatcc portable library). */
+static size_t _base64_encode_len(size_t source_len)
+{
+    return base64_encoded_size(source_len, BASE64_MODE);
+}
+
+static size_t _base64_decode_len(const char* source, size_t source_len)
+{
+    UNUSED(source);
+    return base64_decoded_size(source_len);
+}
+
+static int64_t _base64_encode(
+    const uint8_t* source, size_t source_len, char* dst, size_t dst_cap)
+{
+    size_t len = 0;
+    if (dst_cap < base64_encoded_size(source_len, BASE64_MODE)) {
+        return -EMSGSIZE;
+    }
+    if (base64_encode(
+            (uint8_t*)dst, source, &len, &source_len, BASE64_MODE) != 0) {
+        return -EINVAL;
+    }
+    if (len < dst_cap) dst[len] = '\0';
+    return len;
+}
+
+static int64_t _base64_decode(
+    const char* source, size_t source_len, uint8_t* dst, size_t dst_cap)
+{
+    size_t len = dst_cap;
+    int    rc = base64_decode(
+        dst, (const uint8_t*)source, &len, &source_len, BASE64_MODE);
+    if (rc == BASE64_EMORE) return -EMSGSIZE;
+    if (rc != BASE64_EOK) return -EBADMSG;
+    return len;
+}
+
+
+/* Binary (passthrough) transport. */
+static size_t _binary_encode_len(size_t source_len)
+{
+    return source_len;
+}
+
+static size_t _binary_decode_len(const char* source, size_t source_len)
+{
+    UNUSED(source);
+    return source_len;
+}
+
+static int64_t _binary_encode(
+    const uint8_t* source, size_t source_len, char* dst, size_t dst_cap)
+{
+    if (dst_cap < source_len) return -EMSGSIZE;
+    memcpy(dst, source, source_len);
+    if (source_len < dst_cap) dst[source_len] = '\0';
+    return source_len;
+}
+
+static int64_t _binary_decode(
+    const char* source, size_t source_len, uint8_t* dst, size_t dst_cap)
+{
+    if (dst_cap < source_len) return -EMSGSIZE;
+    memcpy(dst, source, source_len);
+    return source_len;
+}
+
+
+static const NCodecTransport __transports[] = {
+    {
+        .name = "ascii85",
+        .text = true,
+        .encode_len = ascii85_encode_len,
+        .decode_len = ascii85_decode_len,
+        .encode = ascii85_encode_into,
+        .decode = ascii85_decode_into,
+    },
+    {
+        .name = "base64",
+        .text = true,
+        .encode_len = _base64_encode_len,
+        .decode_len = _base64_decode_len,
+        .encode = _base64_encode,
+        .decode = _base64_decode,
+    },
+    {
+        .name = "binary",
+        .text = false,
+        .encode_len = _binary_encode_len,
+        .decode_len = _binary_decode_len,
+        .encode = _binary_encode,
+        .decode = _binary_decode,
+    },
+};
+
+
+/**
+ncodec_transport
+================
+
+Get a transport, which encodes (and decodes) the binary content of a stream
+for exchange via an importer variable.
+
+Parameters
+----------
+name (const char*)
+: The name of the transport ("ascii85", "base64" or "binary"). When NULL the
+  default transport ("ascii85") is returned.
+
+Returns
+-------
+NCodecTransport* (const)
+: The transport, or NULL if the transport is not available.
+*/
+const NCodecTransport* ncodec_transport(const char* name)
+{
+    if (name == NULL) return &__transports[0];
+    for (size_t i = 0; i < sizeof(__transports) / sizeof(__transports[0]);
+         i++) {
+        if (strcmp(name, __transports[i].name) == 0) return &__transports[i];
+    }
+    return NULL;
+}
+
+
+/**
+ncodec_transport_encode
+=======================
+
+Encode a binary string with the specified transport. The encoded content
+is null-terminated.
+
+Parameters
+----------
+transport (const NCodecTransport*)
+: The transport.
+
+source (const uint8_t*)
+: The binary string to be encoded.
+
+source_len (size_t)
+: The length of the binary string.
+
+len (size_t*)
+: Pointer which receives the length of the encoded content (excluding the
+  null terminator), may be NULL.
+
+Returns
+-------
+char*
+: The encoded content, caller to free. NULL on error (errno is set).
+*/
+char* ncodec_transport_encode(const NCodecTransport* transport,
+    const uint8_t* source, size_t source_len, size_t* len)
+{
+    if (transport == NULL) {
+        errno = EINVAL;
+        return NULL;
+    }
+
+    size_t cap = transport->encode_len(source_len) + 1;
+    char*  encoded = malloc(cap);
+    if (encoded == NULL) return NULL;
+    int64_t rc = transport->encode(source, source_len, encoded, cap);
+    if (rc < 0) {
+        free(encoded);
+        errno = -rc;
+        return NULL;
+    }
+    encoded[rc] = '\0';
+    if (len) *len = rc;
+    return encoded;
+}
+
+
+/**
+ncodec_transport_decode
+=======================
+
+Decode content, which was encoded with the specified transport, to a binary
+string.
+
+Parameters
+----------
+transport (const NCodecTransport*)
+: The transport.
+
+source (const char*)
+: The encoded content.
+
+source_len (size_t)
+: The length of the encoded content.
+
+len (size_t*)
+: Pointer which receives the length of the binary string.
+
+Returns
+-------
+uint8_t*
+: The binary string, caller to free. NULL on error (errno is set).
+*/
+uint8_t* ncodec_transport_decode(const NCodecTransport* transport,
+    const char* source, size_t source_len, size_t* len)
+{
+    if (transport == NULL || len == NULL) {
+        errno = EINVAL;
+        return NULL;
+    }
+
+    size_t   cap = transport->decode_len(source, source_len);
+    uint8_t* decoded = malloc(cap ? cap : 1);
+    if (decoded == NULL) return NULL;
+    int64_t rc = transport->decode(source, source_len, decoded, cap);
+    if (rc < 0) {
+        free(decoded);
+        errno = -rc;
+        return NULL;
+    }
+    *len = rc;
+    return decoded;
+}
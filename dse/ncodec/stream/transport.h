@@ -0,0 +1,55 @@
+// Copyright 2025 Robert Bosch GmbH
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef DSE_NCODEC_STREAM_TRANSPORT_H_
+#define DSE_NCODEC_STREAM_TRANSPORT_H_
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <dse/platform.h>
+
+
+/**
+Transport API
+=============
+
+A transport encodes the binary content of a stream for exchange via an
+importer variable (e.g. an FMI 2 String Variable or an FMI 3 Binary
+Variable), and decodes the received content back to binary form.
+
+Available transports:
+  * "ascii85" - text (default).
+  * "base64" - text (RFC 4648, padded).
+  * "binary" - passthrough, for binary variables (e.g. FMI 3).
+*/
+typedef size_t (*NCodecTransportEncodeLen)(size_t source_len);
+typedef size_t (*NCodecTransportDecodeLen)(
+    const char* source, size_t source_len);
+typedef int64_t (*NCodecTransportEncode)(
+    const uint8_t* source, size_t source_len, char* dst, size_t dst_cap);
+typedef int64_t (*NCodecTransportDecode)(
+    const char* source, size_t source_len, uint8_t* dst, size_t dst_cap);
+
+typedef struct NCodecTransport {
+    const char* name;
+    /* Encoded content is text (without null characters). */
+    bool        text;
+
+    NCodecTransportEncodeLen encode_len;
+    NCodecTransportDecodeLen decode_len;
+    NCodecTransportEncode    encode;
+    NCodecTransportDecode    decode;
+} NCodecTransport;
+
+
+/* transport.c */
+DLL_PUBLIC const NCodecTransport* ncodec_transport(const char* name);
+DLL_PUBLIC char* ncodec_transport_encode(const NCodecTransport* transport,
+    const uint8_t* source, size_t source_len, size_t* len);
+DLL_PUBLIC uint8_t* ncodec_transport_decode(const NCodecTransport* transport,
+    const char* source, size_t source_len, size_t* len);
+
+
+#endif  // DSE_NCODEC_STREAM_TRANSPORT_H_
@@ -0,0 +1,155 @@
+// Copyright 2025 Robert Bosch GmbH
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <dse/platform.h>
+#include <dse/ncodec/codec.h>
+#include <dse/ncodec/stream/stream.h>
+#include "bench.h"
+
+
+#define DEFAULT_MIN_TIME 0.2
+
+
+static void _usage(const char* name)
+{
+    fprintf(stderr,
+        "usage: %s [--format csv|json] [--time <seconds>] [--filter <text>] "
+        "[--output <file>]\n",
+        name);
+}
+
+
+int bench_options(int argc, char** argv, BenchOptions* opt)
+{
+    *opt = (BenchOptions){ .min_time = DEFAULT_MIN_TIME, .out = stdout };
+
+    for (int i = 1; i < argc; i++) {
+        const char* arg = argv[i];
+        const char* value = (i + 1 < argc) ? argv[i + 1] : NULL;
+        if (value == NULL) {
+            _usage(argv[0]);
+            return -EINVAL;
+        }
+        if (strcmp(arg, "--format") == 0) {
+            opt->json = (strcmp(value, "json") == 0);
+        } else if (strcmp(arg, "--time") == 0) {
+            opt->min_time = strtod(value, NULL);
+        } else if (strcmp(arg, "--filter") == 0) {
+            opt->filter = value;
+        } else if (strcmp(arg, "--output") == 0) {
+            opt->out = fopen(value, "w");
+            if (opt->out == NULL) return -errno;
+        } else {
+            _usage(argv[0]);
+            return -EINVAL;
+        }
+        i++;
+    }
+    return 0;
+}
+
+
+NCODEC* ncodec_open(const char* mime_type, NCodecStreamVTable* stream)
+{
+    NCODEC* nc = ncodec_create(mime_type);
+    if (nc) {
+        NCodecInstance* _nc = (NCodecInstance*)nc;
+        _nc->stream = stream;
+        _nc->stream_ext = ncodec_stream_ext(stream);
+    }
+    return nc;
+}
+
+
+void bench_open(BenchOptions* opt, const char* columns)
+{
+    if (opt->json) {
+        fprintf(opt->out, "[\n");
+    } else {
+        fprintf(opt->out, "%s\n", columns);
+    }
+}
+
+
+void bench_close(BenchOptions* opt)
+{
+    if (opt->json) fprintf(opt->out, "\n]\n");
+    if (opt->out != stdout) fclose(opt->out);
+}
+
+
+uint64_t bench_now(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_SOURCE, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+
+bool bench_selected(BenchOptions* opt, const char* name)
+{
+    if (opt->filter == NULL) return true;
+    return strstr(name, opt->filter) != NULL;
+}
+
+
+void bench_report(BenchOptions* opt, BenchResult* r)
+{
+    double ops_per_sec = r->seconds > 0 ? r->ops / r->seconds : 0;
+    double mb_per_sec = r->seconds > 0 ? r->bytes / r->seconds / 1e6 : 0;
+
+    if (opt->json) {
+        fprintf(opt->out,
+            "%s  {\"bench\": \"%s\", \"codec\": \"%s\", \"stream\": \"%s\", "
+            "\"transport\": \"%s\", \"payload\": %zu, \"ops\": %llu, "
+            "\"bytes\": %llu, \"seconds\": %.6f, \"ops_per_sec\": %.1f, "
+            "\"mb_per_sec\": %.3f}",
+            opt->results ? ",\n" : "", r->bench, r->codec, r->stream,
+            r->transport, r->payload, (unsigned long long)r->ops,
+            (unsigned long long)r->bytes, r->seconds, ops_per_sec, mb_per_sec);
+    } else {
+        fprintf(opt->out, "%s,%s,%s,%s,%zu,%llu,%llu,%.6f,%.1f,%.3f\n",
+            r->bench, r->codec, r->stream, r->transport, r->payload,
+            (unsigned long long)r->ops, (unsigned long long)r->bytes,
+            r->seconds, ops_per_sec, mb_per_sec);
+    }
+    fflush(opt->out);
+    opt->results++;
+}
+
+
+void bench_bus_report(BenchOptions* opt, BenchBusResult* r)
+{
+    double msg_per_sec = r->seconds > 0 ? r->msg_read / r->seconds : 0;
+    double allocs = r->steps ? (double)r->allocs / r->steps : 0;
+    double builder_allocs = r->steps ? (double)r->builder_allocs / r->steps : 0;
+
+    if (opt->json) {
+        fprintf(opt->out,
+            "%s  {\"bench\": \"%s\", \"codec\": \"%s\", \"nodes\": %zu, "
+            "\"messages\": %zu, \"payload\": %zu, \"steps\": %llu, "
+            "\"step_mean_us\": %.3f, \"step_p50_us\": %.3f, "
+            "\"step_p99_us\": %.3f, \"step_max_us\": %.3f, "
+            "\"msg_per_sec\": %.1f, \"allocs_per_step\": %.2f, "
+            "\"builder_allocs_per_step\": %.2f}",
+            opt->results ? ",\n" : "", r->bench, r->codec, r->nodes,
+            r->messages, r->payload, (unsigned long long)r->steps,
+            r->step_mean / 1e3, r->step_p50 / 1e3, r->step_p99 / 1e3,
+            r->step_max / 1e3, msg_per_sec, allocs, builder_allocs);
+    } else {
+        fprintf(opt->out,
+            "%s,%s,%zu,%zu,%zu,%llu,%.3f,%.3f,%.3f,%.3f,%.1f,%.2f,%.2f\n",
+            r->bench, r->codec, r->nodes, r->messages, r->payload,
+            (unsigned long long)r->steps, r->step_mean / 1e3,
+            r->step_p50 / 1e3, r->step_p99 / 1e3, r->step_max / 1e3,
+            msg_per_sec, allocs, builder_allocs);
+    }
+    fflush(opt->out);
+    opt->results++;
+}
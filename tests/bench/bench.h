@@ -0,0 +1,79 @@
+// Copyright 2025 Robert Bosch GmbH
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef TESTS_BENCH_BENCH_H_
+#define TESTS_BENCH_BENCH_H_
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <dse/ncodec/codec.h>
+
+
+/* CSV columns (header) of the result records. */
+#define BENCH_COLUMNS                                                          \
+    "bench,codec,stream,transport,payload,ops,bytes,seconds,ops_per_sec,"      \
+    "mb_per_sec"
+#define BENCH_BUS_COLUMNS                                                      \
+    "bench,codec,nodes,messages,payload,steps,step_mean_us,step_p50_us,"       \
+    "step_p99_us,step_max_us,msg_per_sec,allocs_per_step,"                     \
+    "builder_allocs_per_step"
+
+/* Benchmark result (one record of the CSV/JSON output). */
+typedef struct BenchResult {
+    const char* bench;
+    const char* codec;
+    const char* stream;
+    const char* transport;
+    size_t      payload;
+    /* Operations (messages, or calls), bytes (payload) and elapsed time. */
+    uint64_t ops;
+    uint64_t bytes;
+    double   seconds;
+} BenchResult;
+
+/* Bus benchmark result (per step measurements of a simulated bus). */
+typedef struct BenchBusResult {
+    const char* bench;
+    const char* codec;
+    size_t      nodes;
+    size_t      messages;
+    size_t      payload;
+    uint64_t    steps;
+    /* Step wall time (nanoseconds). */
+    double      step_mean;
+    uint64_t    step_p50;
+    uint64_t    step_p99;
+    uint64_t    step_max;
+    /* Messages read (all nodes), allocations (heap, codec builder). */
+    uint64_t    msg_read;
+    uint64_t    allocs;
+    uint64_t    builder_allocs;
+    double      seconds;
+} BenchBusResult;
+
+/* Benchmark options (from the command line). */
+typedef struct BenchOptions {
+    double      min_time;
+    const char* filter;
+    bool        json;
+    FILE*       out;
+    /* Internal. */
+    size_t results;
+} BenchOptions;
+
+
+/* bench.c */
+int      bench_options(int argc, char** argv, BenchOptions* opt);
+NCODEC*  ncodec_open(const char* mime_type, NCodecStreamVTable* stream);
+void     bench_open(BenchOptions* opt, const char* columns);
+void     bench_close(BenchOptions* opt);
+uint64_t bench_now(void);
+bool     bench_selected(BenchOptions* opt, const char* name);
+void     bench_report(BenchOptions* opt, BenchResult* result);
+void     bench_bus_report(BenchOptions* opt, BenchBusResult* result);
+
+
+#endif  // TESTS_BENCH_BENCH_H_
@@ -0,0 +1,276 @@
+// Copyright 2025 Robert Bosch GmbH
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <dse/ncodec/codec.h>
+#include <dse/ncodec/codec/ab/codec.h>
+#include <dse/ncodec/instrument/latency.h>
+#include <dse/ncodec/interface/frame.h>
+#include <dse/ncodec/interface/pdu.h>
+#include <dse/ncodec/stream/stream.h>
+#include "bench.h"
+
+
+/* Simulated bus: N nodes (each with a codec instance and a distinct node
+   identity) share one (ring buffer) stream. Each step, every node writes its
+   messages to the bus, then every node reads the bus (filtering its own
+   messages), and finally the consumed bus content is released. The read
+   fan-out of a step is therefore N * (N - 1) * messages. */
+
+
+#define UNUSED(x)     ((void)x)
+#define ARRAY_SIZE(x) (sizeof(x) / sizeof(x[0]))
+
+#define STREAM_CAPACITY (16 * 1024 * 1024)
+#define WARMUP_STEPS    3
+#define MIN_STEPS       10
+#define PAYLOAD_MAX     64
+
+#define PDU_MIME_TYPE                                                          \
+    "application/x-automotive-bus; interface=stream; type=pdu; schema=fbs; "  \
+    "swc_id=%zu; ecu_id=1"
+#define CAN_MIME_TYPE                                                          \
+    "application/x-automotive-bus; interface=stream; type=frame; bus=can; "   \
+    "schema=fbs; bus_id=1; node_id=%zu; interface_id=1"
+
+
+static const char*  benches[] = { "bus", "bus_sender_index" };
+static const char*  codecs[] = { "pdu", "can" };
+static const size_t bus_nodes[] = { 2, 4, 8, 16, 32, 64 };
+static const size_t bus_messages[] = { 1, 16 };
+static const size_t bus_payloads[] = { 8, 64 };
+static uint8_t      payload[PAYLOAD_MAX];
+
+
+/* Allocation counting, the executable is linked with:
+       -Wl,--wrap=malloc,--wrap=calloc,--wrap=realloc */
+static uint64_t alloc_count;
+
+void* __real_malloc(size_t size);
+void* __real_calloc(size_t nmemb, size_t size);
+void* __real_realloc(void* ptr, size_t size);
+
+void* __wrap_malloc(size_t size)
+{
+    alloc_count++;
+    return __real_malloc(size);
+}
+
+void* __wrap_calloc(size_t nmemb, size_t size)
+{
+    alloc_count++;
+    return __real_calloc(nmemb, size);
+}
+
+void* __wrap_realloc(void* ptr, size_t size)
+{
+    alloc_count++;
+    return __real_realloc(ptr, size);
+}
+
+
+typedef struct BusNode {
+    NCODEC* nc;
+    size_t  id;
+} BusNode;
+
+
+static BusNode* _bus_open(const char* codec, size_t nodes, bool sender_index)
+{
+    BusNode* bus = calloc(nodes, sizeof(BusNode));
+    void*    stream = ncodec_ring_stream_create(STREAM_CAPACITY);
+    if (bus == NULL || stream == NULL) {
+        free(bus);
+        return NULL;
+    }
+    for (size_t n = 0; n < nodes; n++) {
+        char mime_type[200];
+        snprintf(mime_type, sizeof(mime_type),
+            strcmp(codec, "pdu") == 0 ? PDU_MIME_TYPE : CAN_MIME_TYPE, n + 1);
+        bus[n].id = n + 1;
+        void* share = n ? ncodec_ring_stream_share(stream) : stream;
+        bus[n].nc = ncodec_open(mime_type, share);
+        ncodec_config(bus[n].nc, (struct NCodecConfigItem){
+                                     .name = "sender_index",
+                                     .value = sender_index ? "1" : "0",
+                                 });
+    }
+    return bus;
+}
+
+static void _bus_close(BusNode* bus, size_t nodes)
+{
+    for (size_t n = 0; n < nodes; n++) {
+        ncodec_close(bus[n].nc);
+    }
+    free(bus);
+}
+
+static uint64_t _bus_builder_allocs(BusNode* bus, size_t nodes)
+{
+    uint64_t count = 0;
+    for (size_t n = 0; n < nodes; n++) {
+        ABCodecStats stats;
+        if (ab_codec_stats(bus[n].nc, &stats, false) == 0) {
+            count += stats.alloc_count;
+        }
+    }
+    return count;
+}
+
+
+static void _node_write(
+    BusNode* node, const char* codec, size_t messages, size_t payload_len)
+{
+    for (size_t i = 0; i < messages; i++) {
+        if (strcmp(codec, "pdu") == 0) {
+            ncodec_write(node->nc, &(struct NCodecPdu){
+                                       .id = node->id * 1000 + i,
+                                       .payload = payload,
+                                       .payload_len = payload_len,
+                                       .swc_id = node->id,
+                                   });
+        } else {
+            ncodec_write(node->nc, &(struct NCodecCanMessage){
+                                       .frame_id = node->id * 1000 + i,
+                                       .buffer = payload,
+                                       .len = payload_len,
+                                   });
+        }
+    }
+    ncodec_flush(node->nc);
+}
+
+static size_t _node_read(BusNode* node, const char* codec)
+{
+    size_t count = 0;
+    while (1) {
+        int rc;
+        if (strcmp(codec, "pdu") == 0) {
+            NCodecPdu msg = {};
+            rc = ncodec_read(node->nc, &msg);
+        } else {
+            NCodecCanMessage msg = {};
+            rc = ncodec_read(node->nc, &msg);
+        }
+        if (rc < 0) break;
+        count++;
+    }
+    return count;
+}
+
+/* One bus step, returns the number of messages read (by all nodes). */
+static size_t _bus_step(BusNode* bus, size_t nodes, const char* codec,
+    size_t messages, size_t payload_len)
+{
+    size_t count = 0;
+    for (size_t n = 0; n < nodes; n++) {
+        _node_write(&bus[n], codec, messages, payload_len);
+    }
+    for (size_t n = 0; n < nodes; n++) {
+        count += _node_read(&bus[n], codec);
+    }
+    /* Release the bus content (consumed by all nodes). */
+    for (size_t n = 0; n < nodes; n++) {
+        ncodec_truncate(bus[n].nc);
+    }
+    return count;
+}
+
+
+static void bench_bus(BenchOptions* opt, const char* bench, const char* codec,
+    size_t nodes, size_t messages, size_t payload_len)
+{
+    char name[100];
+    snprintf(name, sizeof(name), "%s/%s/%zu/%zu/%zu", bench, codec, nodes,
+        messages, payload_len);
+    if (!bench_selected(opt, name)) return;
+
+    bool     sender_index = (strcmp(bench, "bus_sender_index") == 0);
+    BusNode* bus = _bus_open(codec, nodes, sender_index);
+    if (bus == NULL) {
+        fprintf(stderr, "%s: codec/stream not available\n", name);
+        return;
+    }
+    size_t expect = nodes * (nodes - 1) * messages;
+
+    /* Warm up, then measure each step. */
+    for (int i = 0; i < WARMUP_STEPS; i++) {
+        if (_bus_step(bus, nodes, codec, messages, payload_len) != expect) {
+            fprintf(stderr, "%s: read failed\n", name);
+            _bus_close(bus, nodes);
+            return;
+        }
+    }
+    NCodecHistogram* h = calloc(1, sizeof(NCodecHistogram));
+    uint64_t         builder_allocs = _bus_builder_allocs(bus, nodes);
+    uint64_t         allocs = alloc_count;
+    uint64_t         msg_read = 0;
+    uint64_t         start = bench_now();
+    uint64_t         elapsed = 0;
+    do {
+        uint64_t t0 = bench_now();
+        msg_read += _bus_step(bus, nodes, codec, messages, payload_len);
+        uint64_t t1 = bench_now();
+        ncodec_histogram_record(h, t1 - t0);
+        elapsed = t1 - start;
+    } while (elapsed < opt->min_time * 1e9 || h->count < MIN_STEPS);
+    allocs = alloc_count - allocs;
+    builder_allocs = _bus_builder_allocs(bus, nodes) - builder_allocs;
+
+    bench_bus_report(opt, &(BenchBusResult){
+                              .bench = bench,
+                              .codec = codec,
+                              .nodes = nodes,
+                              .messages = messages,
+                              .payload = payload_len,
+                              .steps = h->count,
+                              .step_mean = (double)h->sum / h->count,
+                              .step_p50 = ncodec_histogram_percentile(h, 50.0),
+                              .step_p99 = ncodec_histogram_percentile(h, 99.0),
+                              .step_max = h->max,
+                              .msg_read = msg_read,
+                              .allocs = allocs,
+                              .builder_allocs = builder_allocs,
+                              .seconds = elapsed / 1e9,
+                          });
+    if (msg_read != h->count * expect) {
+        fprintf(stderr, "%s: read failed\n", name);
+    }
+
+    free(h);
+    _bus_close(bus, nodes);
+}
+
+
+int main(int argc, char** argv)
+{
+    BenchOptions opt;
+    if (bench_options(argc, argv, &opt) < 0) return 1;
+
+    /* Reproducible payload. */
+    srand(42);
+    for (size_t i = 0; i < sizeof(payload); i++) {
+        payload[i] = rand() & 0xff;
+    }
+
+    bench_open(&opt, BENCH_BUS_COLUMNS);
+    for (size_t b = 0; b < ARRAY_SIZE(benches); b++) {
+        for (size_t c = 0; c < ARRAY_SIZE(codecs); c++) {
+            for (size_t n = 0; n < ARRAY_SIZE(bus_nodes); n++) {
+                for (size_t m = 0; m < ARRAY_SIZE(bus_messages); m++) {
+                    for (size_t p = 0; p < ARRAY_SIZE(bus_payloads); p++) {
+                        bench_bus(&opt, benches[b], codecs[c], bus_nodes[n],
+                            bus_messages[m], bus_payloads[p]);
+                    }
+                }
+            }
+        }
+    }
+    bench_close(&opt);
+
+    return 0;
+}
@@ -0,0 +1,403 @@
+// Copyright 2025 Robert Bosch GmbH
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <dse/ncodec/codec.h>
+#include <dse/ncodec/interface/frame.h>
+#include <dse/ncodec/interface/pdu.h>
+#include <dse/ncodec/stream/stream.h>
+#include "bench.h"
+
+
+#define UNUSED(x)     ((void)x)
+#define ARRAY_SIZE(x) (sizeof(x) / sizeof(x[0]))
+
+#define STREAM_CAPACITY (16 * 1024 * 1024)
+#define STEP_BYTES      (256 * 1024)
+#define STEP_MSG_MAX    256
+#define PAYLOAD_MAX     (64 * 1024)
+
+#define PDU_MIME_TYPE                                                          \
+    "application/x-automotive-bus; interface=stream; type=pdu; schema=fbs; "  \
+    "swc_id=1; ecu_id=1"
+#define CAN_MIME_TYPE                                                          \
+    "application/x-automotive-bus; interface=stream; type=frame; bus=can; "   \
+    "schema=fbs; bus_id=1; node_id=1; interface_id=1"
+
+
+static const size_t pdu_payloads[] = { 8, 64, 512, 4096, 65536 };
+static const size_t can_payloads[] = { 8, 64 };
+static const size_t a85_payloads[] = { 8, 64, 512, 4096, 65536 };
+static const char*  streams[] = { "buffer", "ring", "shm", "file" };
+static const char*  transports[] = { "none", "can", "ip", "struct" };
+static uint8_t      payload[PAYLOAD_MAX];
+static char         shm_name[64];
+static char         file_path[64];
+
+
+static NCodecStreamVTable* _stream_create(const char* name)
+{
+    if (strcmp(name, "buffer") == 0) {
+        return ncodec_buffer_stream_create(STREAM_CAPACITY);
+    } else if (strcmp(name, "ring") == 0) {
+        return ncodec_ring_stream_create(STREAM_CAPACITY);
+    } else if (strcmp(name, "shm") == 0) {
+        return ncodec_shm_stream_create(shm_name, STREAM_CAPACITY);
+    } else if (strcmp(name, "file") == 0) {
+        return ncodec_file_stream_create(file_path, "w");
+    }
+    return NULL;
+}
+
+
+/* Messages per step: sized so that a step is (about) STEP_BYTES. */
+static size_t _step_count(size_t payload_len)
+{
+    size_t count = STEP_BYTES / payload_len;
+    if (count > STEP_MSG_MAX) count = STEP_MSG_MAX;
+    if (count == 0) count = 1;
+    return count;
+}
+
+
+static void _set_pdu_transport(NCodecPdu* pdu, const char* transport)
+{
+    if (strcmp(transport, "can") == 0) {
+        pdu->transport_type = NCodecPduTransportTypeCan;
+        pdu->transport.can_message = (NCodecPduCanMessageMetadata){
+            .frame_format = NCodecPduCanFrameFormatFdBase,
+            .frame_type = NCodecPduCanFrameTypeData,
+            .interface_id = 3,
+            .network_id = 4,
+        };
+    } else if (strcmp(transport, "ip") == 0) {
+        pdu->transport_type = NCodecPduTransportTypeIp;
+        pdu->transport.ip_message = (NCodecPduIpMessageMetadata){
+            .eth_dst_mac = 0x0000123456789ABC,
+            .eth_src_mac = 0x0000CBA987654321,
+            .eth_ethertype = 0x0800,
+            .ip_protocol = NCodecPduIpProtocolUdp,
+            .ip_addr_type = NCodecPduIpAddrIPv4,
+            .ip_addr = { .ip_v4 = { .src_addr = 0xC0A80001,
+                             .dst_addr = 0xC0A80002 } },
+            .ip_src_port = 30490,
+            .ip_dst_port = 30491,
+            .so_ad_type = NCodecPduSoAdSomeIP,
+            .so_ad = { .some_ip = { .message_id = 0x12345678,
+                           .length = 8,
+                           .request_id = 0x1,
+                           .protocol_version = 1,
+                           .interface_version = 1,
+                           .message_type = 2 } },
+        };
+    } else if (strcmp(transport, "struct") == 0) {
+        pdu->transport_type = NCodecPduTransportTypeStruct;
+        pdu->transport.struct_object = (NCodecPduStructMetadata){
+            .type_name = "VehicleState",
+            .var_name = "vehicle_state",
+            .encoding = "application/x-c-struct",
+            .attribute_aligned = 8,
+            .platform_arch = "amd64",
+            .platform_os = "linux",
+            .platform_abi = "gnu",
+        };
+    } else {
+        pdu->transport_type = NCodecPduTransportTypeNone;
+    }
+}
+
+
+static void _pdu_step_write(NCODEC* nc, NCodecPdu* pdu, size_t count)
+{
+    ncodec_truncate(nc);
+    for (size_t i = 0; i < count; i++) {
+        pdu->id = 1000 + i;
+        ncodec_write(nc, pdu);
+    }
+    ncodec_flush(nc);
+    /* Consume the stream (i.e. release ring content on next truncate). */
+    ncodec_seek(nc, 0, NCODEC_SEEK_END);
+}
+
+static size_t _pdu_step_read(NCODEC* nc)
+{
+    size_t count = 0;
+    ncodec_seek(nc, 0, NCODEC_SEEK_SET);
+    while (1) {
+        NCodecPdu msg = {};
+        if (ncodec_read(nc, &msg) < 0) break;
+        count++;
+    }
+    return count;
+}
+
+
+static void bench_pdu(BenchOptions* opt, const char* stream_name,
+    const char* transport, size_t payload_len)
+{
+    char name[100];
+    snprintf(name, sizeof(name), "pdu/%s/%s/%zu", stream_name, transport,
+        payload_len);
+    if (!bench_selected(opt, name)) return;
+
+    NCODEC* nc = ncodec_open(PDU_MIME_TYPE, _stream_create(stream_name));
+    if (nc == NULL) {
+        fprintf(stderr, "%s: codec/stream not available\n", name);
+        return;
+    }
+    size_t    count = _step_count(payload_len);
+    NCodecPdu pdu = {
+        .payload = payload,
+        .payload_len = payload_len,
+        .swc_id = 2, /* Not filtered by the (reading) codec. */
+    };
+    _set_pdu_transport(&pdu, transport);
+
+    /* Write (encode), warm up then measure. */
+    for (int i = 0; i < 3; i++)
+        _pdu_step_write(nc, &pdu, count);
+    uint64_t steps = 0;
+    uint64_t start = bench_now();
+    uint64_t elapsed = 0;
+    do {
+        _pdu_step_write(nc, &pdu, count);
+        steps++;
+        elapsed = bench_now() - start;
+    } while (elapsed < opt->min_time * 1e9);
+    bench_report(opt, &(BenchResult){
+                          .bench = "write",
+                          .codec = "pdu",
+                          .stream = stream_name,
+                          .transport = transport,
+                          .payload = payload_len,
+                          .ops = steps * count,
+                          .bytes = steps * count * payload_len,
+                          .seconds = elapsed / 1e9,
+                      });
+
+    /* Read (decode), the stream content of one step is read repeatedly. */
+    ncodec_truncate(nc);
+    for (size_t i = 0; i < count; i++)
+        ncodec_write(nc, &pdu);
+    ncodec_flush(nc);
+    if (_pdu_step_read(nc) != count) {
+        fprintf(stderr, "%s: read failed\n", name);
+        ncodec_close(nc);
+        return;
+    }
+    steps = 0;
+    start = bench_now();
+    do {
+        _pdu_step_read(nc);
+        steps++;
+        elapsed = bench_now() - start;
+    } while (elapsed < opt->min_time * 1e9);
+    bench_report(opt, &(BenchResult){
+                          .bench = "read",
+                          .codec = "pdu",
+                          .stream = stream_name,
+                          .transport = transport,
+                          .payload = payload_len,
+                          .ops = steps * count,
+                          .bytes = steps * count * payload_len,
+                          .seconds = elapsed / 1e9,
+                      });
+
+    ncodec_close(nc);
+}
+
+
+static void _can_step_write(NCODEC* nc, NCodecCanMessage* msg, size_t count)
+{
+    ncodec_truncate(nc);
+    for (size_t i = 0; i < count; i++) {
+        msg->frame_id = 100 + i;
+        ncodec_write(nc, msg);
+    }
+    ncodec_flush(nc);
+    ncodec_seek(nc, 0, NCODEC_SEEK_END);
+}
+
+static size_t _can_step_read(NCODEC* nc)
+{
+    size_t count = 0;
+    ncodec_seek(nc, 0, NCODEC_SEEK_SET);
+    while (1) {
+        NCodecCanMessage msg = {};
+        if (ncodec_read(nc, &msg) < 0) break;
+        count++;
+    }
+    return count;
+}
+
+
+static void bench_can(
+    BenchOptions* opt, const char* stream_name, size_t payload_len)
+{
+    char name[100];
+    snprintf(name, sizeof(name), "can/%s/none/%zu", stream_name, payload_len);
+    if (!bench_selected(opt, name)) return;
+
+    NCODEC* nc = ncodec_open(CAN_MIME_TYPE, _stream_create(stream_name));
+    if (nc == NULL) {
+        fprintf(stderr, "%s: codec/stream not available\n", name);
+        return;
+    }
+    size_t           count = _step_count(payload_len);
+    NCodecCanMessage msg = {
+        .buffer = payload,
+        .len = payload_len,
+        .frame_type = payload_len > 8 ? CAN_FD_BASE_FRAME : CAN_BASE_FRAME,
+    };
+
+    /* Write (encode), warm up then measure. */
+    for (int i = 0; i < 3; i++)
+        _can_step_write(nc, &msg, count);
+    uint64_t steps = 0;
+    uint64_t start = bench_now();
+    uint64_t elapsed = 0;
+    do {
+        _can_step_write(nc, &msg, count);
+        steps++;
+        elapsed = bench_now() - start;
+    } while (elapsed < opt->min_time * 1e9);
+    bench_report(opt, &(BenchResult){
+                          .bench = "write",
+                          .codec = "can",
+                          .stream = stream_name,
+                          .transport = "none",
+                          .payload = payload_len,
+                          .ops = steps * count,
+                          .bytes = steps * count * payload_len,
+                          .seconds = elapsed / 1e9,
+                      });
+
+    /* Read (decode), as a different node (node_id filter). */
+    ncodec_truncate(nc);
+    for (size_t i = 0; i < count; i++)
+        ncodec_write(nc, &msg);
+    ncodec_flush(nc);
+    ncodec_config(nc, (NCodecConfigItem){ .name = "node_id", .value = "2" });
+    if (_can_step_read(nc) != count) {
+        fprintf(stderr, "%s: read failed\n", name);
+        ncodec_close(nc);
+        return;
+    }
+    steps = 0;
+    start = bench_now();
+    do {
+        _can_step_read(nc);
+        steps++;
+        elapsed = bench_now() - start;
+    } while (elapsed < opt->min_time * 1e9);
+    bench_report(opt, &(BenchResult){
+                          .bench = "read",
+                          .codec = "can",
+                          .stream = stream_name,
+                          .transport = "none",
+                          .payload = payload_len,
+                          .ops = steps * count,
+                          .bytes = steps * count * payload_len,
+                          .seconds = elapsed / 1e9,
+                      });
+
+    ncodec_close(nc);
+}
+
+
+static void bench_ascii85(BenchOptions* opt, size_t payload_len)
+{
+    char name[100];
+    snprintf(name, sizeof(name), "ascii85/none/none/%zu", payload_len);
+    if (!bench_selected(opt, name)) return;
+
+    size_t   en_cap = ascii85_encode_len(payload_len) + 1;
+    char*    en = malloc(en_cap);
+    uint8_t* de = malloc(payload_len);
+    int64_t  en_len = ascii85_encode_into(payload, payload_len, en, en_cap);
+
+    /* Encode. */
+    uint64_t calls = 0;
+    uint64_t start = bench_now();
+    uint64_t elapsed = 0;
+    do {
+        for (int i = 0; i < 16; i++)
+            ascii85_encode_into(payload, payload_len, en, en_cap);
+        calls += 16;
+        elapsed = bench_now() - start;
+    } while (elapsed < opt->min_time * 1e9);
+    bench_report(opt, &(BenchResult){
+                          .bench = "encode",
+                          .codec = "ascii85",
+                          .stream = "none",
+                          .transport = "none",
+                          .payload = payload_len,
+                          .ops = calls,
+                          .bytes = calls * payload_len,
+                          .seconds = elapsed / 1e9,
+                      });
+
+    /* Decode. */
+    calls = 0;
+    start = bench_now();
+    do {
+        for (int i = 0; i < 16; i++)
+            ascii85_decode_into(en, en_len, de, payload_len);
+        calls += 16;
+        elapsed = bench_now() - start;
+    } while (elapsed < opt->min_time * 1e9);
+    bench_report(opt, &(BenchResult){
+                          .bench = "decode",
+                          .codec = "ascii85",
+                          .stream = "none",
+                          .transport = "none",
+                          .payload = payload_len,
+                          .ops = calls,
+                          .bytes = calls * payload_len,
+                          .seconds = elapsed / 1e9,
+                      });
+    if (memcmp(de, payload, payload_len)) {
+        fprintf(stderr, "%s: round trip failed\n", name);
+    }
+
+    free(en);
+    free(de);
+}
+
+
+int main(int argc, char** argv)
+{
+    BenchOptions opt;
+    if (bench_options(argc, argv, &opt) < 0) return 1;
+
+    /* Reproducible payload. */
+    srand(42);
+    for (size_t i = 0; i < sizeof(payload); i++) {
+        payload[i] = rand() & 0xff;
+    }
+    snprintf(shm_name, sizeof(shm_name), "/ncodec.bench.%d", getpid());
+    snprintf(file_path, sizeof(file_path), "/tmp/ncodec.bench.%d", getpid());
+
+    bench_open(&opt, BENCH_COLUMNS);
+    for (size_t s = 0; s < ARRAY_SIZE(streams); s++) {
+        for (size_t t = 0; t < ARRAY_SIZE(transports); t++) {
+            for (size_t p = 0; p < ARRAY_SIZE(pdu_payloads); p++) {
+                bench_pdu(&opt, streams[s], transports[t], pdu_payloads[p]);
+            }
+        }
+        for (size_t p = 0; p < ARRAY_SIZE(can_payloads); p++) {
+            bench_can(&opt, streams[s], can_payloads[p]);
+        }
+    }
+    for (size_t p = 0; p < ARRAY_SIZE(a85_payloads); p++) {
+        bench_ascii85(&opt, a85_payloads[p]);
+    }
+    bench_close(&opt);
+    unlink(file_path);
+
+    return 0;
+}
@@ -7,6 +7,7 @@
 extern int run_codec_tests(void);
 extern int run_can_fbs_tests(void);
 extern int run_pdu_fbs_tests(void);
+extern int run_latency_tests(void);
 
 
 int main()
@@ -15,5 +16,6 @@ int main()
     rc |= run_codec_tests();
     rc |= run_can_fbs_tests();
     rc |= run_pdu_fbs_tests();
+    rc |= run_latency_tests();
     return rc;
 }
@@ -7,6 +7,7 @@
 #include <stdio.h>
 #include <dse/ncodec/codec.h>
 #include <dse/ncodec/codec/ab/codec.h>
+#include <dse/ncodec/schema/abs/stream/frame_builder.h>
 #include <dse/ncodec/stream/stream.h>
 
 
@@ -276,6 +277,170 @@ void test_can_fbs_readwrite_frames(void** state)
 }
 
 
+void test_can_fbs_sender_index(void** state)
+{
+    Mock*   mock = *state;
+    NCODEC* nc = mock->nc;
+    int     rc;
+
+    const char* greeting = "Hello World";
+    const char* node_ids[] = { "5", "2", "5" };
+    for (int index = 0; index <= 1; index++) {
+        ncodec_config(nc, (struct NCodecConfigItem){
+                              .name = "sender_index",
+                              .value = index ? "1" : "0",
+                          });
+        ncodec_truncate(nc);
+        for (size_t s = 0; s < ARRAY_SIZE(node_ids); s++) {
+            ncodec_config(nc, (struct NCodecConfigItem){
+                                  .name = "node_id",
+                                  .value = node_ids[s],
+                              });
+            for (uint32_t i = 0; i < 2; i++) {
+                ncodec_write(nc, &(struct NCodecCanMessage){
+                                     .frame_id = s * 10 + i,
+                                     .buffer = (uint8_t*)greeting,
+                                     .len = strlen(greeting) });
+            }
+            ncodec_flush(nc);
+        }
+
+        /* Check the index (Stream.node_uid) of each stream. */
+        uint8_t* buffer;
+        size_t   len;
+        ncodec_seek(nc, 0, NCODEC_SEEK_SET);
+        stream_read(nc, &buffer, &len, NCODEC_POS_NC);
+        for (size_t s = 0; s < ARRAY_SIZE(node_ids); s++) {
+            size_t   msg_len = 0;
+            uint8_t* msg = flatbuffers_read_size_prefix(buffer, &msg_len);
+            assert_int_not_equal(msg_len, 0);
+            uint32_t uid = AutomotiveBus_Stream_Frame_Stream_node_uid(
+                AutomotiveBus_Stream_Frame_Stream_as_root(msg));
+            assert_int_equal(
+                uid, index ? AB_SENDER_INDEX(atoi(node_ids[s])) : 0);
+            buffer = msg + msg_len;
+        }
+
+        /* Read (node_id=2), the frames of node 2 are filtered. */
+        ncodec_config(nc, (struct NCodecConfigItem){
+                              .name = "node_id",
+                              .value = "2",
+                          });
+        ABCodecStats stats;
+        ab_codec_stats(nc, &stats, true);
+        uint32_t         expect_id[] = { 0, 1, 20, 21 };
+        size_t           count = 0;
+        NCodecCanMessage msg = {};
+        while ((rc = ncodec_read(nc, &msg)) >= 0) {
+            assert_true(count < ARRAY_SIZE(expect_id));
+            assert_int_equal(msg.frame_id, expect_id[count]);
+            assert_int_equal(msg.sender.node_id, 5);
+            count++;
+        }
+        assert_int_equal(rc, -ENOMSG);
+        assert_int_equal(count, ARRAY_SIZE(expect_id));
+        ab_codec_stats(nc, &stats, false);
+        assert_int_equal(stats.msg_read, 4);
+        assert_int_equal(stats.msg_filtered, 2);
+    }
+}
+
+
+void test_can_fbs_sender_index_filtered(void** state)
+{
+    Mock*   mock = *state;
+    NCODEC* nc = mock->nc;
+
+    ncodec_config(nc, (struct NCodecConfigItem){
+                          .name = "sender_index",
+                          .value = "1",
+                      });
+
+    /* Stream sent by this codec (node_id=2), with a CAN frame and a frame
+       without content. */
+    flatcc_builder_t B;
+    flatcc_builder_init(&B);
+    AutomotiveBus_Stream_Frame_Stream_start_as_root_with_size(&B);
+    AutomotiveBus_Stream_Frame_Stream_frames_start(&B);
+    AutomotiveBus_Stream_Frame_Stream_frames_push_start(&B);
+    AutomotiveBus_Stream_Frame_CanFrame_start(&B);
+    AutomotiveBus_Stream_Frame_CanFrame_frame_id_add(&B, 42);
+    AutomotiveBus_Stream_Frame_CanFrame_node_id_add(&B, 2);
+    AutomotiveBus_Stream_Frame_Frame_f_CanFrame_add(
+        &B, AutomotiveBus_Stream_Frame_CanFrame_end(&B));
+    AutomotiveBus_Stream_Frame_Stream_frames_push_end(&B);
+    AutomotiveBus_Stream_Frame_Stream_frames_push_start(&B);
+    AutomotiveBus_Stream_Frame_Stream_frames_push_end(&B);
+    AutomotiveBus_Stream_Frame_Stream_frames_end(&B);
+    AutomotiveBus_Stream_Frame_Stream_node_uid_add(&B, AB_SENDER_INDEX(2));
+    AutomotiveBus_Stream_Frame_Stream_end_as_root(&B);
+    size_t   size = 0;
+    uint8_t* buffer = flatcc_builder_finalize_buffer(&B, &size);
+    assert_non_null(buffer);
+    ncodec_truncate(nc);
+    NCodecStreamVTable* stream = ((NCodecInstance*)nc)->stream;
+    assert_int_equal(stream->write(nc, buffer, size), size);
+    free(buffer);
+    flatcc_builder_clear(&B);
+
+    /* The stream is skipped, only the CAN frame is counted as filtered. */
+    ABCodecStats stats;
+    ab_codec_stats(nc, &stats, true);
+    ncodec_seek(nc, 0, NCODEC_SEEK_SET);
+    NCodecCanMessage msg = {};
+    assert_int_equal(ncodec_read(nc, &msg), -ENOMSG);
+    ab_codec_stats(nc, &stats, false);
+    assert_int_equal(stats.msg_read, 0);
+    assert_int_equal(stats.msg_filtered, 1);
+}
+
+
+void test_can_fbs_readwrite_batch(void** state)
+{
+    Mock*   mock = *state;
+    NCODEC* nc = mock->nc;
+    int     rc;
+
+    const char*      greeting1 = "Hello World";
+    const char*      greeting2 = "Foo Bar";
+    NCodecCanMessage msgs[2] = {
+        { .frame_id = 42,
+            .buffer = (uint8_t*)greeting1,
+            .len = strlen(greeting1) },
+        { .frame_id = 43,
+            .buffer = (uint8_t*)greeting2,
+            .len = strlen(greeting2) },
+    };
+
+    // Write and flush the messages (same encoding as single writes).
+    ncodec_seek(nc, 0, NCODEC_SEEK_RESET);
+    rc = ncodec_write_batch(nc, msgs, 2, sizeof(NCodecCanMessage));
+    assert_int_equal(rc, 2);
+    size_t len = ncodec_flush(nc);
+    assert_int_equal(len, 0x92);
+
+    // Seek to the start, keeping the content, modify the node_id.
+    ncodec_seek(nc, 0, NCODEC_SEEK_SET);
+    uint8_t* buffer;
+    size_t   buffer_len;
+    stream_read(nc, &buffer, &buffer_len, NCODEC_POS_NC);
+    buffer[BUF_NODEID_OFFSET + 4] = 8;
+    buffer[BUF_NODEID_OFFSET + 4 + 40] = 8;
+
+    // Read the messages back (more requested than available).
+    NCodecCanMessage rx[4] = {};
+    rc = ncodec_read_batch(nc, rx, 4, sizeof(NCodecCanMessage));
+    assert_int_equal(rc, 2);
+    for (int i = 0; i < 2; i++) {
+        assert_int_equal(rx[i].frame_id, msgs[i].frame_id);
+        assert_int_equal(rx[i].len, msgs[i].len);
+        assert_memory_equal(rx[i].buffer, msgs[i].buffer, msgs[i].len);
+    }
+    rc = ncodec_read_batch(nc, rx, 4, sizeof(NCodecCanMessage));
+    assert_int_equal(rc, -ENOMSG);
+}
+
+
 void test_can_fbs_readwrite_messages(void** state)
 {
     Mock*   mock = *state;
@@ -395,8 +560,12 @@ int run_can_fbs_tests(void)
         cmocka_unit_test_setup_teardown(test_can_fbs_readwrite, s, t),
         cmocka_unit_test_setup_teardown(test_can_fbs_readwrite_frames, s, t),
         cmocka_unit_test_setup_teardown(test_can_fbs_readwrite_messages, s, t),
+        cmocka_unit_test_setup_teardown(test_can_fbs_readwrite_batch, s, t),
         cmocka_unit_test_setup_teardown(test_can_fbs_truncate, s, t),
         cmocka_unit_test_setup_teardown(test_can_fbs_frame_type, s, t),
+        cmocka_unit_test_setup_teardown(test_can_fbs_sender_index, s, t),
+        cmocka_unit_test_setup_teardown(
+            test_can_fbs_sender_index_filtered, s, t),
     };
 
     return cmocka_run_group_tests_name("CAN FBS", can_fbs_tests, NULL, NULL);
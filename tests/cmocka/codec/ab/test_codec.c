@@ -15,7 +15,7 @@
 
 extern void             free_codec(ABCodecInstance* nc);
 extern char*            trim(char* s);
-extern void             codec_config(NCODEC* nc, NCodecConfigItem item);
+extern int32_t          codec_config(NCODEC* nc, NCodecConfigItem item);
 extern NCodecConfigItem codec_stat(NCODEC* nc, int* index);
 extern NCODEC*          ncodec_create(const char* mime_type);
 extern void             codec_close(NCODEC* nc);
@@ -23,10 +23,18 @@ extern int32_t          can_write(NCODEC* nc, NCodecMessage* msg);
 extern int32_t          can_read(NCODEC* nc, NCodecMessage* msg);
 extern int32_t          can_flush(NCODEC* nc);
 extern int32_t          can_truncate(NCODEC* nc);
+extern int32_t          can_write_batch(
+             NCODEC* nc, NCodecMessage* msgs, size_t count, size_t size);
+extern int32_t          can_read_batch(
+             NCODEC* nc, NCodecMessage* msgs, size_t count, size_t size);
 extern int32_t          pdu_write(NCODEC* nc, NCodecMessage* msg);
 extern int32_t          pdu_read(NCODEC* nc, NCodecMessage* msg);
 extern int32_t          pdu_flush(NCODEC* nc);
 extern int32_t          pdu_truncate(NCODEC* nc);
+extern int32_t          pdu_write_batch(
+             NCODEC* nc, NCodecMessage* msgs, size_t count, size_t size);
+extern int32_t          pdu_read_batch(
+             NCODEC* nc, NCodecMessage* msgs, size_t count, size_t size);
 
 
 NCODEC* ncodec_open(const char* mime_type, NCodecStreamVTable* stream)
@@ -35,6 +43,7 @@ NCODEC* ncodec_open(const char* mime_type, NCodecStreamVTable* stream)
     if (nc) {
         NCodecInstance* _nc = (NCodecInstance*)nc;
         _nc->stream = stream;
+        _nc->stream_ext = ncodec_stream_ext(stream);
     }
     return nc;
 }
@@ -260,6 +269,17 @@ void test_codec_stat(void** state)
         { .index = 6, .name = "interface_id", .value = "3" },
         { .index = 7, .name = "swc_id", .value = "4" },
         { .index = 8, .name = "ecu_id", .value = "5" },
+        /* Statistics. */
+        { .index = 9, .name = "msg_written", .value = "0" },
+        { .index = 10, .name = "msg_read", .value = "0" },
+        { .index = 11, .name = "payload_written", .value = "0" },
+        { .index = 12, .name = "payload_read", .value = "0" },
+        { .index = 13, .name = "encoded_bytes", .value = "0" },
+        { .index = 14, .name = "msg_filtered", .value = "0" },
+        { .index = 15, .name = "flush_count", .value = "0" },
+        { .index = 16, .name = "max_buffer", .value = "0" },
+        { .index = 17, .name = "alloc_count", .value = "0" },
+        { .index = 18, .name = "msg_rejected", .value = "0" },
         { .index = -1, .name = "foo", .value = "bar" },
     };
 
@@ -292,6 +312,78 @@ void test_codec_stat(void** state)
 }
 
 
+/* Types as laid out by the NCodec API header of NCODEC_ABI_VERSION 1. */
+typedef struct NCodecStreamVTableV1 {
+    NCodecStreamRead  read;
+    NCodecStreamWrite write;
+    NCodecStreamSeek  seek;
+    NCodecStreamTell  tell;
+    NCodecStreamEof   eof;
+    NCodecStreamClose close;
+} NCodecStreamVTableV1;
+
+typedef struct NCodecInstanceV1 {
+    const char* mime_type;
+    struct {
+        NCodecConfig   config;
+        NCodecStat     stat;
+        NCodecWrite    write;
+        NCodecRead     read;
+        NCodecFlush    flush;
+        NCodecTruncate truncate;
+        NCodecClose    close;
+    } codec;
+    NCodecStreamVTableV1* stream;
+    struct {
+        NCodecTraceWrite write;
+        NCodecTraceRead  read;
+    } trace;
+    void* private;
+} NCodecInstanceV1;
+
+typedef struct CodecInstanceV1 {
+    NCodecInstanceV1 c;
+    uint8_t          private_field;
+} CodecInstanceV1;
+
+
+void test_ncodec_instance_layout(void** state)
+{
+    UNUSED(state);
+
+    /* The fields of version 1 keep their offsets (integrators). */
+    assert_int_equal(NCODEC_ABI_VERSION, 2);
+    NCodecInstanceV1 v1;
+    assert_int_equal(sizeof(NCodecVTable), sizeof(v1.codec));
+    assert_int_equal(sizeof(NCodecStreamVTable), sizeof(NCodecStreamVTableV1));
+    assert_int_equal(sizeof(NCodecTraceVTable), sizeof(v1.trace));
+    assert_int_equal(offsetof(NCodecInstance, mime_type),
+        offsetof(NCodecInstanceV1, mime_type));
+    assert_int_equal(
+        offsetof(NCodecInstance, codec), offsetof(NCodecInstanceV1, codec));
+    assert_int_equal(
+        offsetof(NCodecInstance, stream), offsetof(NCodecInstanceV1, stream));
+    assert_int_equal(
+        offsetof(NCodecInstance, trace), offsetof(NCodecInstanceV1, trace));
+    assert_int_equal(offsetof(NCodecInstance, private),
+        offsetof(NCodecInstanceV1, private));
+
+    /* The extensions are appended ... */
+    assert_true(
+        offsetof(NCodecInstance, instrument) >= sizeof(NCodecInstanceV1));
+    assert_true(offsetof(NCodecInstance, batch) >
+                offsetof(NCodecInstance, instrument));
+    assert_true(offsetof(NCodecInstance, stream_ext) >
+                offsetof(NCodecInstance, batch));
+
+    /* ... where a codec built with version 1 has its private fields (ABI
+       break, such a codec must be rebuilt). */
+    assert_int_equal(offsetof(CodecInstanceV1, private_field),
+        offsetof(NCodecInstance, instrument));
+    assert_true(sizeof(NCodecInstance) > sizeof(NCodecInstanceV1));
+}
+
+
 void test_ncodec_can_create_close(void** state)
 {
     UNUSED(state);
@@ -323,6 +415,8 @@ void test_ncodec_can_create_close(void** state)
     assert_ptr_equal(nc->codec.flush, can_flush);
     assert_ptr_equal(nc->codec.truncate, can_truncate);
     assert_ptr_equal(nc->codec.close, codec_close);
+    assert_ptr_equal(nc->batch.write, can_write_batch);
+    assert_ptr_equal(nc->batch.read, can_read_batch);
 
     /* Check the values. */
     size_t tc_count = 0;
@@ -376,6 +470,8 @@ void test_ncodec_pdu_create_close(void** state)
     assert_ptr_equal(nc->codec.flush, pdu_flush);
     assert_ptr_equal(nc->codec.truncate, pdu_truncate);
     assert_ptr_equal(nc->codec.close, codec_close);
+    assert_ptr_equal(nc->batch.write, pdu_write_batch);
+    assert_ptr_equal(nc->batch.read, pdu_read_batch);
 
     /* Check the values. */
     size_t tc_count = 0;
@@ -502,6 +598,487 @@ void test_ncodec_call_sequence(void** state)
 }
 
 
+static int _step(NCODEC* nc, size_t count)
+{
+    const char* greeting = "Hello World";
+    ncodec_truncate(nc);
+    for (size_t i = 0; i < count; i++) {
+        int rc = ncodec_write(nc, &(struct NCodecPdu){ .id = 42 + i,
+                                      .payload = (uint8_t*)greeting,
+                                      .payload_len = strlen(greeting),
+                                      .swc_id = 4 });
+        assert_int_equal(strlen(greeting), rc);
+    }
+    ncodec_flush(nc);
+    ncodec_seek(nc, 0, NCODEC_SEEK_SET);
+    int msg_count = 0;
+    while (1) {
+        NCodecPdu msg = {};
+        if (ncodec_read(nc, &msg) < 0) break;
+        assert_int_equal(42 + msg_count, msg.id);
+        assert_memory_equal(greeting, msg.payload, strlen(greeting));
+        msg_count++;
+    }
+    return msg_count;
+}
+
+
+void test_ncodec_arena(void** state)
+{
+    UNUSED(state);
+
+    const char*         mime_type = "application/x-automotive-bus; "
+                                    "interface=stream;type=pdu;schema=fbs;"
+                                    "swc_id=1;arena=1024";
+    NCodecStreamVTable* stream = ncodec_buffer_stream_create(0);
+    NCODEC*             nc = ncodec_open(mime_type, stream);
+    assert_non_null(nc);
+    ABCodecInstance* _nc = (ABCodecInstance*)nc;
+    assert_int_equal(_nc->arena.chunk_size, 1024);
+
+    /* Warm up, then no further allocations. */
+    assert_int_equal(_step(nc, 20), 20);
+    assert_non_null(_nc->arena.chunks);
+    ABArenaChunk* chunks = _nc->arena.chunks;
+    size_t        used = chunks->used;
+    for (int i = 0; i < 10; i++) {
+        assert_int_equal(_step(nc, 1 + i % 20), 1 + i % 20);
+        assert_ptr_equal(_nc->arena.chunks, chunks);
+        assert_int_equal(_nc->arena.chunks->used, used);
+    }
+
+    /* Reconfigure, default allocator. */
+    assert_int_equal(codec_config(nc, (struct NCodecConfigItem){ .name = "arena",
+                                          .value = "0" }),
+        0);
+    assert_null(_nc->arena.chunks);
+    assert_int_equal(_step(nc, 5), 5);
+    assert_null(_nc->arena.chunks);
+
+    ncodec_close((void*)nc);
+}
+
+
+void test_ncodec_arena_reuse(void** state)
+{
+    UNUSED(state);
+
+    ABArena        arena = { .chunk_size = 1024 };
+    flatcc_iovec_t a = { 0 };
+    flatcc_iovec_t b = { 0 };
+    flatcc_iovec_t c = { 0 };
+
+    assert_int_equal(arena_alloc(&arena, &a, 64, 0, 0), 0);
+    assert_int_equal(arena_alloc(&arena, &b, 64, 0, 0), 0);
+    void* a_base = a.iov_base;
+
+    /* Grow (move) the first buffer, its previous block is released. */
+    assert_int_equal(arena_alloc(&arena, &a, 128, 0, 0), 0);
+    assert_true(a.iov_base != a_base);
+    assert_ptr_equal(arena.free_list, a_base);
+
+    /* The released block is reused (zero filled). */
+    size_t used = arena.chunks->used;
+    assert_int_equal(arena_alloc(&arena, &c, 48, 1, 0), 0);
+    assert_ptr_equal(c.iov_base, a_base);
+    assert_int_equal(c.iov_len, 64);
+    assert_int_equal(((uint8_t*)c.iov_base)[0], 0);
+    assert_int_equal(arena.chunks->used, used);
+    assert_null(arena.free_list);
+
+    /* Released blocks are reused, best fit. */
+    assert_int_equal(arena_alloc(&arena, &a, 0, 0, 0), 0);
+    assert_int_equal(arena_alloc(&arena, &c, 0, 0, 0), 0);
+    assert_int_equal(arena_alloc(&arena, &c, 32, 0, 0), 0);
+    assert_ptr_equal(c.iov_base, a_base);
+
+    arena_destroy(&arena);
+    assert_null(arena.chunks);
+    assert_null(arena.free_list);
+}
+
+
+void test_ncodec_builder_reserve(void** state)
+{
+    UNUSED(state);
+
+    const char*         mime_type = "application/x-automotive-bus; "
+                                    "interface=stream;type=pdu;schema=fbs;"
+                                    "swc_id=1;builder_reserve=65536;"
+                                    "builder_retain=1";
+    NCodecStreamVTable* stream = ncodec_buffer_stream_create(0);
+    NCODEC*             nc = ncodec_open(mime_type, stream);
+    assert_non_null(nc);
+    ABCodecInstance* _nc = (ABCodecInstance*)nc;
+    ABEmitter*       E = &_nc->emitter;
+    assert_int_equal(_nc->builder_reserve, 65536);
+    assert_true(_nc->builder_retain);
+
+    /* Capacity is reserved at open. */
+    size_t capacity = E->capacity;
+    assert_true(capacity >= 65536);
+
+    /* Capacity is retained across (small) steps, without allocations after
+       the first step (which grows the builder stacks). */
+    assert_int_equal(_step(nc, 1), 1);
+    size_t   alloc_count = _nc->stats.alloc_count;
+    uint8_t* block = E->block;
+    for (int i = 0; i < 20; i++) {
+        assert_int_equal(_step(nc, 1), 1);
+        assert_int_equal(E->capacity, capacity);
+        assert_ptr_equal(E->block, block);
+    }
+    assert_int_equal(_nc->stats.alloc_count, alloc_count);
+
+    /* Without retain, the emitter block shrinks. */
+    assert_int_equal(codec_config(nc, (struct NCodecConfigItem){
+                                          .name = "builder_retain",
+                                          .value = "0" }),
+        0);
+    for (int i = 0; i < 20; i++) {
+        assert_int_equal(_step(nc, 1), 1);
+    }
+    assert_true(E->capacity < capacity);
+
+    ncodec_close((void*)nc);
+}
+
+
+void test_ncodec_stats(void** state)
+{
+    UNUSED(state);
+
+    const char*         mime_type = "application/x-automotive-bus; "
+                                    "interface=stream;type=pdu;schema=fbs;"
+                                    "swc_id=1";
+    NCodecStreamVTable* stream = ncodec_buffer_stream_create(0);
+    NCODEC*             nc = ncodec_open(mime_type, stream);
+    assert_non_null(nc);
+
+    /* Step: 5 messages written, and read. */
+    ABCodecStats stats = {};
+    assert_int_equal(_step(nc, 5), 5);
+    assert_int_equal(ab_codec_stats(nc, &stats, false), 0);
+    assert_int_equal(stats.msg_written, 5);
+    assert_int_equal(stats.msg_read, 5);
+    assert_int_equal(stats.payload_written, 5 * strlen("Hello World"));
+    assert_int_equal(stats.payload_read, 5 * strlen("Hello World"));
+    assert_int_equal(stats.msg_filtered, 0);
+    assert_int_equal(stats.flush_count, 1);
+    assert_true(stats.encoded_bytes > stats.payload_written);
+    assert_int_equal(stats.max_buffer, stats.encoded_bytes);
+    assert_true(stats.alloc_count > 0);
+
+    /* Stat interface (value strings are allocated on first use). */
+    assert_null(((ABCodecInstance*)nc)->stats_str);
+    int              index = 9;
+    NCodecConfigItem ci = ncodec_stat(nc, &index);
+    assert_int_equal(index, 9);
+    assert_non_null(((ABCodecInstance*)nc)->stats_str);
+    assert_string_equal(ci.name, "msg_written");
+    assert_string_equal(ci.value, "5");
+    /* Each counter has its own value (i.e. values are retained while the
+       remaining statistics are enumerated). */
+    index = 15;
+    NCodecConfigItem ci_flush = ncodec_stat(nc, &index);
+    assert_string_equal(ci_flush.name, "flush_count");
+    assert_string_equal(ci_flush.value, "1");
+    assert_string_equal(ci.value, "5");
+
+    /* Messages from this node are filtered. */
+    assert_int_equal(ab_codec_stats(nc, &stats, true), 0);
+    ncodec_truncate(nc);
+    ncodec_write(nc, &(struct NCodecPdu){ .id = 1, .swc_id = 1 });
+    ncodec_write(nc, &(struct NCodecPdu){ .id = 2, .swc_id = 4 });
+    ncodec_flush(nc);
+    ncodec_seek(nc, 0, NCODEC_SEEK_SET);
+    NCodecPdu msg = {};
+    assert_int_equal(ncodec_read(nc, &msg), 0);
+    assert_int_equal(msg.id, 2);
+    assert_true(ncodec_read(nc, &msg) < 0);
+    assert_int_equal(ab_codec_stats(nc, &stats, true), 0);
+    assert_int_equal(stats.msg_written, 2);
+    assert_int_equal(stats.msg_read, 1);
+    assert_int_equal(stats.msg_filtered, 1);
+    assert_int_equal(stats.flush_count, 1);
+
+    /* Counters were reset. */
+    assert_int_equal(ab_codec_stats(nc, &stats, false), 0);
+    assert_int_equal(stats.msg_written, 0);
+    assert_int_equal(stats.encoded_bytes, 0);
+    assert_int_equal(ab_codec_stats(NULL, &stats, false), -ENOSTR);
+
+    ncodec_close((void*)nc);
+}
+
+
+void test_ncodec_static_dispatch(void** state)
+{
+    UNUSED(state);
+
+    const char* greeting = "Hello World";
+
+    /* PDU stream. */
+    NCODEC* nc = ncodec_open("application/x-automotive-bus; "
+                             "interface=stream;type=pdu;schema=fbs;swc_id=1",
+        ncodec_buffer_stream_create(0));
+    assert_non_null(nc);
+    NCodecPdu pdus[3] = {
+        { .id = 1, .payload = (uint8_t*)greeting, .payload_len = 5, .swc_id = 4 },
+        { .id = 2, .payload = (uint8_t*)greeting, .payload_len = 11, .swc_id = 4 },
+        { .id = 3, .swc_id = 1 },
+    };
+    assert_int_equal(ab_pdu_truncate(nc), 0);
+    assert_int_equal(ab_pdu_write(nc, &pdus[0]), 5);
+    assert_int_equal(ab_pdu_write_batch(nc, &pdus[1], 2), 2);
+    assert_true(ab_pdu_flush(nc) > 0);
+    ncodec_seek(nc, 0, NCODEC_SEEK_SET);
+    NCodecPdu msg = {};
+    assert_int_equal(ab_pdu_read(nc, &msg), 5);
+    assert_int_equal(msg.id, 1);
+    NCodecPdu msgs[3] = {};
+    assert_int_equal(ab_pdu_read_batch(nc, msgs, 3), 1);
+    assert_int_equal(msgs[0].id, 2);
+    assert_memory_equal(msgs[0].payload, greeting, 11);
+    assert_int_equal(ab_pdu_read(nc, &msg), -ENOMSG);
+    ncodec_close(nc);
+
+    /* CAN frame stream. */
+    nc = ncodec_open("application/x-automotive-bus; "
+                     "interface=stream;type=frame;bus=can;schema=fbs;node_id=1",
+        ncodec_buffer_stream_create(0));
+    assert_non_null(nc);
+    NCodecCanMessage frames[2] = {
+        { .frame_id = 1, .buffer = (uint8_t*)greeting, .len = 5 },
+        { .frame_id = 2, .buffer = (uint8_t*)greeting, .len = 11 },
+    };
+    assert_int_equal(ab_can_truncate(nc), 0);
+    assert_int_equal(ab_can_write(nc, &frames[0]), 5);
+    assert_int_equal(ab_can_write_batch(nc, &frames[1], 1), 1);
+    assert_true(ab_can_flush(nc) > 0);
+    ncodec_seek(nc, 0, NCODEC_SEEK_SET);
+    _adjust_node_id(nc, "2");
+    NCodecCanMessage frame = {};
+    assert_int_equal(ab_can_read(nc, &frame), 5);
+    assert_int_equal(frame.frame_id, 1);
+    NCodecCanMessage rx[2] = {};
+    assert_int_equal(ab_can_read_batch(nc, rx, 2), 1);
+    assert_int_equal(rx[0].frame_id, 2);
+    assert_int_equal(ab_can_read(nc, &frame), -ENOMSG);
+    ncodec_close(nc);
+}
+
+
+typedef struct AllocCounter {
+    size_t count;
+} AllocCounter;
+
+static int _counting_alloc(void* alloc_context, flatcc_iovec_t* b,
+    size_t request, int zero_fill, int alloc_type)
+{
+    AllocCounter* counter = alloc_context;
+    counter->count++;
+    return flatcc_builder_default_alloc(
+        NULL, b, request, zero_fill, alloc_type);
+}
+
+void test_ncodec_builder_lazy(void** state)
+{
+    UNUSED(state);
+
+    const char* mime_type[] = {
+        "application/x-automotive-bus; interface=stream;type=pdu;schema=fbs;"
+        "swc_id=1",
+        "application/x-automotive-bus; interface=stream;type=frame;bus=can;"
+        "schema=fbs;node_id=1",
+    };
+    for (size_t i = 0; i < ARRAY_SIZE(mime_type); i++) {
+        NCodecStreamVTable* stream = ncodec_buffer_stream_create(0);
+        NCODEC*             nc = ncodec_open(mime_type[i], stream);
+        assert_non_null(nc);
+        ABCodecInstance* _nc = (ABCodecInstance*)nc;
+
+        /* Read only, no builder. */
+        NCodecPdu        pdu = {};
+        NCodecCanMessage msg = {};
+        assert_int_equal(ncodec_read(nc, i ? (void*)&msg : (void*)&pdu),
+            -ENOMSG);
+        assert_int_equal(ncodec_flush(nc), 0);
+        assert_int_equal(ncodec_truncate(nc), 0);
+        assert_null(_nc->fbs_builder);
+
+        /* Builder is initialised on first write. */
+        if (i) {
+            ncodec_write(nc, &(struct NCodecCanMessage){ .frame_id = 42 });
+        } else {
+            ncodec_write(nc, &(struct NCodecPdu){ .id = 42, .swc_id = 4 });
+        }
+        assert_non_null(_nc->fbs_builder);
+        assert_true(ncodec_flush(nc) > 0);
+
+        ncodec_close((void*)nc);
+    }
+}
+
+
+void test_ncodec_set_allocator(void** state)
+{
+    UNUSED(state);
+
+    const char*         mime_type = "application/x-automotive-bus; "
+                                    "interface=stream;type=pdu;schema=fbs;"
+                                    "swc_id=1";
+    NCodecStreamVTable* stream = ncodec_buffer_stream_create(0);
+    NCODEC*             nc = ncodec_open(mime_type, stream);
+    assert_non_null(nc);
+
+    AllocCounter counter = {};
+    assert_int_equal(ab_codec_set_allocator(nc, _counting_alloc, &counter), 0);
+    assert_int_equal(_step(nc, 10), 10);
+    assert_true(counter.count > 0);
+
+    /* Builder contains content. */
+    ncodec_write(nc, &(struct NCodecPdu){ .id = 1, .swc_id = 4 });
+    assert_int_equal(ab_codec_set_allocator(nc, NULL, NULL), -EBUSY);
+    ncodec_truncate(nc);
+    assert_int_equal(ab_codec_set_allocator(nc, NULL, NULL), 0);
+    assert_int_equal(ab_codec_set_allocator(NULL, NULL, NULL), -ENOSTR);
+
+    ncodec_close((void*)nc);
+}
+
+
+void test_ncodec_filter(void** state)
+{
+    UNUSED(state);
+
+    const char* pdu_mime_type = "application/x-automotive-bus; "
+                                "interface=stream;type=pdu;schema=fbs;"
+                                "swc_id=1";
+    NCODEC*     nc = ncodec_open(pdu_mime_type, ncodec_buffer_stream_create(0));
+    assert_non_null(nc);
+    ABCodecInstance* _nc = (ABCodecInstance*)nc;
+
+    /* Set the filter (ranges are merged). */
+    ABFilterRange ranges[] = {
+        { 150, 250 }, { 100, 199 }, { 251, 260 }, { 5000, 5000 }
+    };
+    ABFilterMask masks[] = { { 0x7E0, 0x7F0 }, { 0x18DA0000, 0x1FFF0000 } };
+    assert_int_equal(ab_codec_set_filter(nc, ranges, ARRAY_SIZE(ranges), masks,
+                         ARRAY_SIZE(masks)),
+        0);
+    assert_non_null(_nc->filter);
+    assert_int_equal(_nc->filter->range_count, 2);
+    struct {
+        uint32_t id;
+        bool     accept;
+    } tc[] = {
+        { 0, false },
+        { 99, false },
+        { 100, true },
+        { 260, true },
+        { 261, false },
+        { 0x7E5, true },
+        { 0x7F0, false },
+        { 4999, false },
+        { 5000, true },
+        { 5001, false },
+        { 0x18DA00F1, true },
+        { 0x18DB0000, false },
+    };
+    for (size_t i = 0; i < ARRAY_SIZE(tc); i++) {
+        assert_int_equal(filter_accept(_nc->filter, tc[i].id), tc[i].accept);
+        assert_int_equal(filter_match(_nc->filter, tc[i].id), tc[i].accept);
+    }
+
+    /* Errors. */
+    ABFilterRange bad_range = { 10, 9 };
+    assert_int_equal(ab_codec_set_filter(nc, &bad_range, 1, NULL, 0), -EINVAL);
+    assert_int_equal(ab_codec_set_filter(NULL, NULL, 0, NULL, 0), -ENOSTR);
+    const char* bad_spec[] = { "abc", "1-", "1/x", "1+2", "1,,2-", "-1",
+        "0x100000000", "1-4294967296", "1/99999999999999999999999", "1--2" };
+    for (size_t i = 0; i < ARRAY_SIZE(bad_spec); i++) {
+        assert_int_equal(codec_config(nc, (struct NCodecConfigItem){
+                                              .name = "filter",
+                                              .value = bad_spec[i],
+                                          }),
+            -EINVAL);
+    }
+    assert_non_null(_nc->filter);
+
+    /* Space separated specification (each space delimits a token). */
+    assert_int_equal(codec_config(nc, (struct NCodecConfigItem){
+                                          .name = "filter",
+                                          .value = "1 3 5 7 9 11, 13 15-16",
+                                      }),
+        0);
+    assert_non_null(_nc->filter);
+    assert_int_equal(_nc->filter->range_count, 8);
+    assert_true(filter_match(_nc->filter, 11));
+    assert_true(filter_match(_nc->filter, 16));
+    assert_false(filter_match(_nc->filter, 12));
+
+    /* Remove the filter. */
+    assert_int_equal(codec_config(nc, (struct NCodecConfigItem){
+                                          .name = "filter",
+                                          .value = "",
+                                      }),
+        0);
+    assert_null(_nc->filter);
+
+    /* Read PDUs, with a filter from the MIMEtype (8/0xE matches 8 and 9). */
+    ncodec_close(nc);
+    nc = ncodec_open("application/x-automotive-bus; "
+                     "interface=stream;type=pdu;schema=fbs;"
+                     "swc_id=1;filter=2,5-6,8/0xE",
+        ncodec_buffer_stream_create(0));
+    assert_non_null(nc);
+    for (uint32_t id = 1; id <= 10; id++) {
+        ncodec_write(nc, &(struct NCodecPdu){ .id = id, .swc_id = 4 });
+    }
+    ncodec_flush(nc);
+    ncodec_seek(nc, 0, NCODEC_SEEK_SET);
+    uint32_t  expect_pdu[] = { 2, 5, 6, 8, 9 };
+    size_t    count = 0;
+    NCodecPdu pdu = {};
+    while (ncodec_read(nc, &pdu) >= 0) {
+        assert_true(count < ARRAY_SIZE(expect_pdu));
+        assert_int_equal(pdu.id, expect_pdu[count++]);
+    }
+    assert_int_equal(count, ARRAY_SIZE(expect_pdu));
+    ABCodecStats stats;
+    ab_codec_stats(nc, &stats, false);
+    assert_int_equal(stats.msg_read, 5);
+    assert_int_equal(stats.msg_rejected, 5);
+    ncodec_close(nc);
+
+    /* Read CAN frames. */
+    nc = ncodec_open("application/x-automotive-bus; "
+                     "interface=stream;type=frame;bus=can;schema=fbs;"
+                     "node_id=1;filter=0x100/0x7FE",
+        ncodec_buffer_stream_create(0));
+    assert_non_null(nc);
+    _adjust_node_id(nc, "2");
+    for (uint32_t id = 0x100; id < 0x104; id++) {
+        ncodec_write(nc, &(struct NCodecCanMessage){ .frame_id = id });
+    }
+    ncodec_flush(nc);
+    _adjust_node_id(nc, "1");
+    ncodec_seek(nc, 0, NCODEC_SEEK_SET);
+    uint32_t         expect_can[] = { 0x100, 0x101 };
+    NCodecCanMessage msg = {};
+    count = 0;
+    while (ncodec_read(nc, &msg) >= 0) {
+        assert_true(count < ARRAY_SIZE(expect_can));
+        assert_int_equal(msg.frame_id, expect_can[count++]);
+    }
+    assert_int_equal(count, ARRAY_SIZE(expect_can));
+    ab_codec_stats(nc, &stats, false);
+    assert_int_equal(stats.msg_rejected, 2);
+    ncodec_close(nc);
+}
+
+
 int run_codec_tests(void)
 {
     void* s = test_setup;
@@ -511,10 +1088,19 @@ int run_codec_tests(void)
         cmocka_unit_test_setup_teardown(test_trim, s, t),
         cmocka_unit_test_setup_teardown(test_codec_config, s, t),
         cmocka_unit_test_setup_teardown(test_codec_stat, s, t),
+        cmocka_unit_test_setup_teardown(test_ncodec_instance_layout, s, t),
         cmocka_unit_test_setup_teardown(test_ncodec_can_create_close, s, t),
         cmocka_unit_test_setup_teardown(test_ncodec_pdu_create_close, s, t),
         cmocka_unit_test_setup_teardown(test_ncodec_create_failon_mime, s, t),
         cmocka_unit_test_setup_teardown(test_ncodec_call_sequence, s, t),
+        cmocka_unit_test_setup_teardown(test_ncodec_arena, s, t),
+        cmocka_unit_test_setup_teardown(test_ncodec_arena_reuse, s, t),
+        cmocka_unit_test_setup_teardown(test_ncodec_builder_reserve, s, t),
+        cmocka_unit_test_setup_teardown(test_ncodec_builder_lazy, s, t),
+        cmocka_unit_test_setup_teardown(test_ncodec_set_allocator, s, t),
+        cmocka_unit_test_setup_teardown(test_ncodec_stats, s, t),
+        cmocka_unit_test_setup_teardown(test_ncodec_static_dispatch, s, t),
+        cmocka_unit_test_setup_teardown(test_ncodec_filter, s, t),
     };
 
     return cmocka_run_group_tests_name("CODEC", codec_tests, NULL, NULL);
@@ -0,0 +1,143 @@
+// Copyright 2025 Robert Bosch GmbH
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#include <dse/testing.h>
+#include <errno.h>
+#include <string.h>
+#include <dse/ncodec/codec.h>
+#include <dse/ncodec/interface/pdu.h>
+#include <dse/ncodec/instrument/latency.h>
+#include <dse/ncodec/stream/stream.h>
+
+
+#define UNUSED(x) ((void)x)
+
+
+extern NCODEC* ncodec_open(const char* mime_type, NCodecStreamVTable* stream);
+
+
+void test_latency_histogram(void** state)
+{
+    UNUSED(state);
+    NCodecHistogram* h = calloc(1, sizeof(NCodecHistogram));
+
+    /* Empty. */
+    assert_int_equal(ncodec_histogram_percentile(h, 99.0), 0);
+
+    /* Exact values (below the sub bucket count). */
+    for (uint64_t v = 1; v <= 10; v++) {
+        ncodec_histogram_record(h, v);
+    }
+    assert_int_equal(h->count, 10);
+    assert_int_equal(h->min, 1);
+    assert_int_equal(h->max, 10);
+    assert_int_equal(h->sum, 55);
+    assert_int_equal(ncodec_histogram_percentile(h, 50.0), 5);
+    assert_int_equal(ncodec_histogram_percentile(h, 90.0), 9);
+    assert_int_equal(ncodec_histogram_percentile(h, 100.0), 10);
+
+    /* Values within the resolution of the histogram. */
+    ncodec_histogram_reset(h);
+    assert_int_equal(h->count, 0);
+    for (uint64_t v = 1; v <= 100000; v++) {
+        ncodec_histogram_record(h, v * 10);
+    }
+    uint64_t p50 = ncodec_histogram_percentile(h, 50.0);
+    uint64_t p99 = ncodec_histogram_percentile(h, 99.0);
+    assert_true(p50 >= 500000 && p50 <= 500000 + 500000 / 16);
+    assert_true(p99 >= 990000 && p99 <= 990000 + 990000 / 16);
+    assert_int_equal(ncodec_histogram_percentile(h, 100.0), 1000000);
+    assert_int_equal(ncodec_histogram_percentile(h, 0.0), 10);
+
+    /* Large values, recorded in the last bucket. */
+    ncodec_histogram_record(h, UINT64_MAX);
+    assert_int_equal(h->buckets[NCODEC_HISTOGRAM_BUCKETS - 1], 1);
+    assert_int_equal(ncodec_histogram_percentile(h, 100.0), UINT64_MAX);
+
+    free(h);
+}
+
+
+void test_latency_instrument(void** state)
+{
+    UNUSED(state);
+
+    const char*         mime_type = "application/x-automotive-bus; "
+                                    "interface=stream;type=pdu;schema=fbs;"
+                                    "swc_id=1";
+    NCodecStreamVTable* stream = ncodec_buffer_stream_create(0);
+    NCODEC*             nc = ncodec_open(mime_type, stream);
+    assert_non_null(nc);
+    assert_null(ncodec_latency(nc));
+    NCodecLatency* l = ncodec_latency_attach(nc);
+    assert_non_null(l);
+    assert_ptr_equal(ncodec_latency(nc), l);
+    assert_ptr_equal(ncodec_latency_attach(nc), l);
+
+    /* Operations are recorded. */
+    const char* greeting = "Hello World";
+    for (int step = 0; step < 3; step++) {
+        ncodec_truncate(nc);
+        for (int i = 0; i < 4; i++) {
+            ncodec_write(nc, &(struct NCodecPdu){ .id = 42,
+                                 .payload = (uint8_t*)greeting,
+                                 .payload_len = strlen(greeting),
+                                 .swc_id = 4 });
+        }
+        NCodecPdu pdus[2] = { { .id = 43, .swc_id = 4 },
+            { .id = 44, .swc_id = 4 } };
+        ncodec_write_batch(nc, pdus, 2, sizeof(NCodecPdu));
+        ncodec_flush(nc);
+        ncodec_seek(nc, 0, NCODEC_SEEK_SET);
+        NCodecPdu msg = {};
+        while (ncodec_read(nc, &msg) >= 0) {
+        }
+        assert_int_equal(ncodec_read_batch(nc, pdus, 2, sizeof(NCodecPdu)),
+            -ENOMSG);
+    }
+    assert_int_equal(l->op[NCODEC_OP_WRITE].count, 12);
+    assert_int_equal(l->op[NCODEC_OP_WRITE_BATCH].count, 3);
+    assert_int_equal(l->op[NCODEC_OP_READ].count, 3 * (6 + 1));
+    assert_int_equal(l->op[NCODEC_OP_READ_BATCH].count, 3);
+    assert_int_equal(l->op[NCODEC_OP_FLUSH].count, 3);
+    assert_int_equal(l->op[NCODEC_OP_TRUNCATE].count, 3);
+    assert_true(l->op[NCODEC_OP_FLUSH].max > 0);
+    assert_true(ncodec_histogram_percentile(&l->op[NCODEC_OP_WRITE], 99.0) <=
+                l->op[NCODEC_OP_WRITE].max);
+
+    /* Detach, and attach again. */
+    ncodec_latency_detach(nc);
+    assert_null(ncodec_latency(nc));
+    ncodec_flush(nc);
+    l = ncodec_latency_attach(nc);
+    assert_non_null(l);
+    assert_int_equal(l->op[NCODEC_OP_FLUSH].count, 0);
+
+    /* Other instrumentation attached. */
+    NCodecInstance* _nc = (NCodecInstance*)nc;
+    ncodec_latency_detach(nc);
+    _nc->instrument.end = (NCodecInstrumentEnd)1;
+    errno = 0;
+    assert_null(ncodec_latency_attach(nc));
+    assert_int_equal(errno, EBUSY);
+    _nc->instrument.end = NULL;
+
+    /* Instrumentation is released when the codec is closed. */
+    assert_non_null(ncodec_latency_attach(nc));
+    ncodec_close(nc);
+}
+
+
+int run_latency_tests(void)
+{
+    void* s = NULL;
+    void* t = NULL;
+
+    const struct CMUnitTest latency_tests[] = {
+        cmocka_unit_test_setup_teardown(test_latency_histogram, s, t),
+        cmocka_unit_test_setup_teardown(test_latency_instrument, s, t),
+    };
+
+    return cmocka_run_group_tests_name("LATENCY", latency_tests, NULL, NULL);
+}
@@ -7,6 +7,7 @@
 #include <stdio.h>
 #include <dse/ncodec/codec.h>
 #include <dse/ncodec/codec/ab/codec.h>
+#include <dse/ncodec/schema/abs/stream/pdu_builder.h>
 #include <dse/ncodec/stream/stream.h>
 
 
@@ -16,6 +17,7 @@
 
 
 extern NCodecConfigItem codec_stat(NCODEC* nc, int* index);
+extern int32_t          codec_config(NCODEC* nc, NCodecConfigItem item);
 extern NCODEC*          ncodec_create(const char* mime_type);
 extern int32_t stream_read(NCODEC* nc, uint8_t** data, size_t* len, int pos_op);
 
@@ -110,6 +112,190 @@ void test_pdu_fbs_flush(void** state)
 }
 
 
+void test_pdu_fbs_flush_reserve(void** state)
+{
+    Mock*   mock = *state;
+    NCODEC* nc = mock->nc;
+    int     rc;
+
+    const char* greeting = "Hello World";
+    NCodecPdu   pdu = { .id = 42,
+          .payload = (uint8_t*)greeting,
+          .payload_len = strlen(greeting) };
+
+    // Flush via reserve/commit (buffer stream).
+    NCodecInstance* _nc = (NCodecInstance*)nc;
+    assert_non_null(_nc->stream_ext);
+    rc = ncodec_write(nc, &pdu);
+    assert_int_equal(rc, strlen(greeting));
+    rc = ncodec_flush(nc);
+    assert_int_equal(rc, 0x56);
+    assert_int_equal(ncodec_tell(nc), 0x56);
+    ncodec_seek(nc, 0, NCODEC_SEEK_SET);
+    uint8_t* reserved_buffer;
+    size_t   reserved_len;
+    stream_read(nc, &reserved_buffer, &reserved_len, NCODEC_POS_NC);
+    assert_int_equal(reserved_len, 0x56);
+
+    // Flush via write (stream without reserve/commit), same content.
+    ncodec_truncate(nc);
+    _nc->stream_ext = NULL;
+    rc = ncodec_write(nc, &pdu);
+    assert_int_equal(rc, strlen(greeting));
+    rc = ncodec_flush(nc);
+    assert_int_equal(rc, 0x56);
+    ncodec_seek(nc, 0, NCODEC_SEEK_SET);
+    uint8_t* buffer;
+    size_t   buffer_len;
+    stream_read(nc, &buffer, &buffer_len, NCODEC_POS_NC);
+    assert_int_equal(buffer_len, 0x56);
+    assert_ptr_equal(buffer, reserved_buffer);
+
+    // Stream too small, nothing is written.
+    NCODEC* small_nc =
+        (void*)ncodec_open(MIMETYPE, ncodec_buffer_stream_create(0x20));
+    assert_non_null(small_nc);
+    rc = ncodec_write(small_nc, &pdu);
+    assert_int_equal(rc, strlen(greeting));
+    rc = ncodec_flush(small_nc);
+    assert_int_equal(rc, -EMSGSIZE);
+    assert_int_equal(ncodec_tell(small_nc), 0);
+    ncodec_close(small_nc);
+}
+
+
+void test_pdu_fbs_flush_large(void** state)
+{
+    UNUSED(state);
+    int rc;
+
+    /* Resizable stream, content exceeds a single emitter page. */
+    NCodecStreamVTable* stream = ncodec_buffer_stream_create(0);
+    NCODEC*             nc = (void*)ncodec_open(MIMETYPE, stream);
+    assert_non_null(nc);
+
+    uint8_t payload[200];
+    for (uint32_t i = 0; i < sizeof(payload); i++)
+        payload[i] = i;
+    for (uint32_t i = 0; i < 100; i++) {
+        payload[0] = i;
+        rc = ncodec_write(nc, &(struct NCodecPdu){ .id = i + 1,
+                                  .payload = payload,
+                                  .payload_len = sizeof(payload),
+                                  .swc_id = 42 });
+        assert_int_equal(rc, sizeof(payload));
+    }
+    size_t len = ncodec_flush(nc);
+    assert_true(len > 100 * sizeof(payload));
+    assert_int_equal(ncodec_tell(nc), len);
+
+    // Read the messages back.
+    ncodec_seek(nc, 0, NCODEC_SEEK_SET);
+    for (uint32_t i = 0; i < 100; i++) {
+        NCodecPdu pdu = {};
+        rc = ncodec_read(nc, &pdu);
+        assert_int_equal(rc, sizeof(payload));
+        assert_int_equal(pdu.id, i + 1);
+        assert_int_equal(pdu.payload[0], i);
+        assert_memory_equal(&pdu.payload[1], &payload[1], sizeof(payload) - 1);
+    }
+    NCodecPdu pdu = {};
+    rc = ncodec_read(nc, &pdu);
+    assert_int_equal(rc, -ENOMSG);
+
+    ncodec_close(nc);
+}
+
+
+void test_pdu_fbs_flush_failed(void** state)
+{
+    UNUSED(state);
+    int rc;
+
+    /* Fixed size stream, without reserve/commit (buffer is written). */
+    NCodecStreamVTable* stream = ncodec_buffer_stream_create(8192);
+    NCODEC*             nc = (void*)ncodec_open(MIMETYPE, stream);
+    assert_non_null(nc);
+    ((NCodecInstance*)nc)->stream_ext = NULL;
+
+    // First flush, fits in the stream.
+    const char* greeting = "Hello World";
+    rc = ncodec_write(nc, &(struct NCodecPdu){ .id = 42,
+                              .payload = (uint8_t*)greeting,
+                              .payload_len = strlen(greeting),
+                              .swc_id = 42 });
+    assert_int_equal(rc, strlen(greeting));
+    int32_t len = ncodec_flush(nc);
+    assert_true(len > 0);
+
+    // Second flush, exceeds the stream, nothing is written.
+    uint8_t payload[200] = { 0 };
+    for (uint32_t i = 0; i < 100; i++) {
+        rc = ncodec_write(nc, &(struct NCodecPdu){ .id = i + 1,
+                                  .payload = payload,
+                                  .payload_len = sizeof(payload),
+                                  .swc_id = 42 });
+        assert_int_equal(rc, sizeof(payload));
+    }
+    rc = ncodec_flush(nc);
+    assert_int_equal(rc, -EMSGSIZE);
+    assert_int_equal(ncodec_tell(nc), len);
+
+    // Third flush, continues from the position of the first flush.
+    rc = ncodec_write(nc, &(struct NCodecPdu){ .id = 43,
+                              .payload = (uint8_t*)greeting,
+                              .payload_len = strlen(greeting),
+                              .swc_id = 42 });
+    assert_int_equal(rc, strlen(greeting));
+    assert_int_equal(ncodec_flush(nc), len);
+    assert_int_equal(ncodec_tell(nc), 2 * len);
+
+    // Read back, only the successful flushes are present.
+    ncodec_seek(nc, 0, NCODEC_SEEK_SET);
+    NCodecPdu pdu = {};
+    rc = ncodec_read(nc, &pdu);
+    assert_int_equal(rc, strlen(greeting));
+    assert_int_equal(pdu.id, 42);
+    pdu = (NCodecPdu){};
+    rc = ncodec_read(nc, &pdu);
+    assert_int_equal(rc, strlen(greeting));
+    assert_int_equal(pdu.id, 43);
+    pdu = (NCodecPdu){};
+    rc = ncodec_read(nc, &pdu);
+    assert_int_equal(rc, -ENOMSG);
+
+    ncodec_close(nc);
+
+    /* Ring buffer stream (reserve/commit), the reservation of a failed flush
+       is abandoned and nothing is published. */
+    NCodecStreamVTable* tx_stream = ncodec_ring_stream_create(4096);
+    NCodecStreamVTable* rx_stream = ncodec_ring_stream_share(tx_stream);
+    NCODEC*             tx = (void*)ncodec_open(MIMETYPE, tx_stream);
+    NCODEC*             rx = (void*)ncodec_open(MIMETYPE, rx_stream);
+    assert_non_null(tx);
+    assert_non_null(rx);
+    for (uint32_t i = 0; i < 100; i++) {
+        rc = ncodec_write(tx, &(struct NCodecPdu){ .id = i + 1,
+                                  .payload = payload,
+                                  .payload_len = sizeof(payload),
+                                  .swc_id = 42 });
+        assert_int_equal(rc, sizeof(payload));
+    }
+    assert_int_equal(ncodec_flush(tx), -EMSGSIZE);
+    assert_int_equal(ncodec_read(rx, &pdu), -ENOMSG);
+    rc = ncodec_write(tx, &(struct NCodecPdu){ .id = 43,
+                              .payload = (uint8_t*)greeting,
+                              .payload_len = strlen(greeting),
+                              .swc_id = 42 });
+    assert_int_equal(ncodec_flush(tx), len);
+    assert_int_equal(ncodec_read(rx, &pdu), strlen(greeting));
+    assert_int_equal(pdu.id, 43);
+    assert_int_equal(ncodec_read(rx, &pdu), -ENOMSG);
+    ncodec_close(tx);
+    ncodec_close(rx);
+}
+
+
 void test_pdu_fbs_truncate(void** state)
 {
     Mock*   mock = *state;
@@ -292,6 +478,349 @@ void test_pdu_fbs_readwrite_pdus(void** state)
 }
 
 
+void test_pdu_fbs_ring_stream(void** state)
+{
+    UNUSED(state);
+    int rc;
+
+    /* Producer and consumer codecs connected by a ring buffer stream. */
+    NCodecStreamVTable* tx_stream = ncodec_ring_stream_create(512);
+    NCodecStreamVTable* rx_stream = ncodec_ring_stream_share(tx_stream);
+    NCODEC*             tx = (void*)ncodec_open(MIMETYPE, tx_stream);
+    NCODEC*             rx = (void*)ncodec_open(MIMETYPE, rx_stream);
+    assert_non_null(tx);
+    assert_non_null(rx);
+
+    const char* greeting = "Hello World";
+    uint32_t    id = 0;
+    uint32_t    rx_id = 0;
+    for (uint32_t step = 0; step < 20; step++) {
+        /* Produce (some steps produce twice before the consumer reads). */
+        for (uint32_t i = 0; i < 1 + (step % 2); i++) {
+            ncodec_truncate(tx);
+            for (uint32_t j = 0; j < 3; j++) {
+                rc = ncodec_write(tx, &(struct NCodecPdu){ .id = ++id,
+                                          .payload = (uint8_t*)greeting,
+                                          .payload_len = strlen(greeting),
+                                          .swc_id = 42 });
+                assert_int_equal(rc, strlen(greeting));
+            }
+            rc = ncodec_flush(tx);
+            assert_true(rc > 0);
+        }
+        if (step % 2 == 0) continue;
+
+        /* Consume, then release the consumed content. */
+        NCodecPdu pdu = {};
+        while ((rc = ncodec_read(rx, &pdu)) >= 0) {
+            assert_int_equal(rc, strlen(greeting));
+            assert_int_equal(pdu.id, ++rx_id);
+            assert_memory_equal(pdu.payload, greeting, strlen(greeting));
+        }
+        assert_int_equal(rc, -ENOMSG);
+        assert_int_equal(rx_id, id);
+        ncodec_truncate(rx);
+    }
+    assert_int_equal(rx_id, 90);
+
+    ncodec_close(tx);
+    ncodec_close(rx);
+}
+
+
+void test_pdu_fbs_ring_stream_write(void** state)
+{
+    UNUSED(state);
+    int rc;
+
+    /* Ring buffer stream without reserve/commit, each flush exceeds a single
+       emitter page and must be published as a single (contiguous) message. */
+    NCodecStreamVTable* tx_stream = ncodec_ring_stream_create(16 * 1024);
+    NCodecStreamVTable* rx_stream = ncodec_ring_stream_share(tx_stream);
+    NCODEC*             tx = (void*)ncodec_open(MIMETYPE, tx_stream);
+    NCODEC*             rx = (void*)ncodec_open(MIMETYPE, rx_stream);
+    assert_non_null(tx);
+    assert_non_null(rx);
+    ((NCodecInstance*)tx)->stream_ext = NULL;
+
+    uint8_t  payload[1000] = { 0 };
+    uint32_t id = 0;
+    uint32_t rx_id = 0;
+    for (uint32_t step = 0; step < 20; step++) {
+        ncodec_truncate(tx);
+        for (uint32_t i = 0; i < 5; i++) {
+            payload[0] = (uint8_t)id;
+            rc = ncodec_write(tx, &(struct NCodecPdu){ .id = ++id,
+                                      .payload = payload,
+                                      .payload_len = sizeof(payload),
+                                      .swc_id = 42 });
+            assert_int_equal(rc, sizeof(payload));
+        }
+        rc = ncodec_flush(tx);
+        assert_true(rc > 5 * (int)sizeof(payload));
+
+        NCodecPdu pdu = {};
+        uint32_t  count = 0;
+        while ((rc = ncodec_read(rx, &pdu)) >= 0) {
+            assert_int_equal(rc, sizeof(payload));
+            assert_int_equal(pdu.id, ++rx_id);
+            assert_int_equal(pdu.payload[0], (uint8_t)(rx_id - 1));
+            count++;
+        }
+        assert_int_equal(rc, -ENOMSG);
+        assert_int_equal(count, 5);
+        ncodec_truncate(rx);
+    }
+    assert_int_equal(rx_id, 100);
+
+    ncodec_close(tx);
+    ncodec_close(rx);
+}
+
+
+void test_pdu_fbs_sender_index(void** state)
+{
+    Mock* mock = *state;
+    int   rc;
+
+    const char* greeting = "Hello World";
+    uint32_t    senders[][3] = {
+        { 4, 4, 4 }, /* Sent by this codec, indexed. */
+        { 7, 7, 7 }, /* Sent by another codec, indexed. */
+        { 4, 7, 4 }, /* Mixed, not indexed. */
+    };
+    for (int index = 0; index <= 1; index++) {
+        ncodec_config(mock->nc, (struct NCodecConfigItem){
+                                    .name = "sender_index",
+                                    .value = index ? "1" : "0",
+                                });
+        ncodec_truncate(mock->nc);
+        for (size_t s = 0; s < ARRAY_SIZE(senders); s++) {
+            for (uint32_t i = 0; i < 3; i++) {
+                ncodec_write(mock->nc, &(struct NCodecPdu){ .id = s * 10 + i,
+                                           .payload = (uint8_t*)greeting,
+                                           .payload_len = strlen(greeting),
+                                           .swc_id = senders[s][i] });
+            }
+            ncodec_flush(mock->nc);
+        }
+
+        /* Check the index (Stream.node_uid) of each stream. */
+        uint8_t* buffer;
+        size_t   len;
+        ncodec_seek(mock->nc, 0, NCODEC_SEEK_SET);
+        stream_read(mock->nc, &buffer, &len, NCODEC_POS_NC);
+        uint32_t expect_uid[] = { AB_SENDER_INDEX(4), AB_SENDER_INDEX(7), 0 };
+        for (size_t s = 0; s < ARRAY_SIZE(senders); s++) {
+            size_t   msg_len = 0;
+            uint8_t* msg = flatbuffers_read_size_prefix(buffer, &msg_len);
+            assert_int_not_equal(msg_len, 0);
+            uint32_t uid = AutomotiveBus_Stream_Pdu_Stream_node_uid(
+                AutomotiveBus_Stream_Pdu_Stream_as_root(msg));
+            assert_int_equal(uid, index ? expect_uid[s] : 0);
+            buffer = msg + msg_len;
+        }
+
+        /* Read, the same messages are filtered with or without the index. */
+        ABCodecStats stats;
+        ab_codec_stats(mock->nc, &stats, true);
+        uint32_t  expect_id[] = { 10, 11, 12, 21 };
+        size_t    count = 0;
+        NCodecPdu pdu = {};
+        while ((rc = ncodec_read(mock->nc, &pdu)) >= 0) {
+            assert_true(count < ARRAY_SIZE(expect_id));
+            assert_int_equal(pdu.id, expect_id[count]);
+            assert_int_not_equal(pdu.swc_id, 4);
+            count++;
+        }
+        assert_int_equal(rc, -ENOMSG);
+        assert_int_equal(count, ARRAY_SIZE(expect_id));
+        ab_codec_stats(mock->nc, &stats, false);
+        assert_int_equal(stats.msg_read, 4);
+        assert_int_equal(stats.msg_filtered, 5);
+    }
+}
+
+
+static void _write_stream_with_uid(NCODEC* nc, uint32_t node_uid)
+{
+    flatcc_builder_t B;
+    flatcc_builder_init(&B);
+    AutomotiveBus_Stream_Pdu_Stream_start_as_root_with_size(&B);
+    AutomotiveBus_Stream_Pdu_Stream_pdus_start(&B);
+    AutomotiveBus_Stream_Pdu_Stream_pdus_push_start(&B);
+    AutomotiveBus_Stream_Pdu_Pdu_id_add(&B, 42);
+    AutomotiveBus_Stream_Pdu_Pdu_swc_id_add(&B, 7);
+    AutomotiveBus_Stream_Pdu_Stream_pdus_push_end(&B);
+    AutomotiveBus_Stream_Pdu_Stream_pdus_end(&B);
+    AutomotiveBus_Stream_Pdu_Stream_node_uid_add(&B, node_uid);
+    AutomotiveBus_Stream_Pdu_Stream_end_as_root(&B);
+    size_t   size = 0;
+    uint8_t* buffer = flatcc_builder_finalize_buffer(&B, &size);
+    assert_non_null(buffer);
+    NCodecStreamVTable* stream = ((NCodecInstance*)nc)->stream;
+    assert_int_equal(stream->write(nc, buffer, size), size);
+    free(buffer);
+    flatcc_builder_clear(&B);
+}
+
+
+void test_pdu_fbs_sender_index_marker(void** state)
+{
+    Mock*     mock = *state;
+    NCodecPdu pdu = {};
+    int       rc;
+
+    ncodec_config(mock->nc, (struct NCodecConfigItem){
+                                .name = "sender_index",
+                                .value = "1",
+                            });
+
+    /* Stream.node_uid set by another writer (no sender index marker), with
+       the same value as the swc_id of this codec. The stream is not skipped. */
+    ncodec_truncate(mock->nc);
+    _write_stream_with_uid(mock->nc, 4);
+    ncodec_seek(mock->nc, 0, NCODEC_SEEK_SET);
+    rc = ncodec_read(mock->nc, &pdu);
+    assert_int_equal(rc, 0);
+    assert_int_equal(pdu.id, 42);
+    assert_int_equal(pdu.swc_id, 7);
+
+    /* Stream tagged with the sender index of this codec, skipped. */
+    ncodec_truncate(mock->nc);
+    _write_stream_with_uid(mock->nc, AB_SENDER_INDEX(4));
+    ncodec_seek(mock->nc, 0, NCODEC_SEEK_SET);
+    rc = ncodec_read(mock->nc, &pdu);
+    assert_int_equal(rc, -ENOMSG);
+
+    /* Sender does not fit in the index (low 16 bits are the swc_id of this
+       codec), the stream is not tagged and not skipped. */
+    ncodec_truncate(mock->nc);
+    rc = ncodec_write(mock->nc, &(struct NCodecPdu){ .id = 43,
+                                    .payload = (uint8_t*)"Hello",
+                                    .payload_len = 5,
+                                    .swc_id = 0x10004 });
+    assert_int_equal(rc, 5);
+    ncodec_flush(mock->nc);
+    uint8_t* buffer;
+    size_t   len;
+    ncodec_seek(mock->nc, 0, NCODEC_SEEK_SET);
+    stream_read(mock->nc, &buffer, &len, NCODEC_POS_NC);
+    uint8_t* msg = flatbuffers_read_size_prefix(buffer, &len);
+    assert_int_equal(AutomotiveBus_Stream_Pdu_Stream_node_uid(
+                         AutomotiveBus_Stream_Pdu_Stream_as_root(msg)),
+        0);
+    rc = ncodec_read(mock->nc, &pdu);
+    assert_int_equal(rc, 5);
+    assert_int_equal(pdu.id, 43);
+    assert_int_equal(pdu.swc_id, 0x10004);
+}
+
+
+void test_pdu_fbs_readwrite_batch(void** state)
+{
+    Mock*   mock = *state;
+    NCODEC* nc = mock->nc;
+    int     rc;
+
+    const char* greeting1 = "Hello World";
+    const char* greeting2 = "Foo Bar";
+    NCodecPdu   pdus[2] = {
+        { .id = 42,
+              .payload = (uint8_t*)greeting1,
+              .payload_len = strlen(greeting1),
+              .swc_id = 42,
+              .ecu_id = 24 },
+        { .id = 43,
+              .payload = (uint8_t*)greeting2,
+              .payload_len = strlen(greeting2),
+              .swc_id = 42,
+              .ecu_id = 24 },
+    };
+
+    for (int native = 1; native >= 0; native--) {
+        if (native == 0) {
+            /* Use the generic (per-message) implementation. */
+            ((NCodecInstance*)nc)->batch.write = NULL;
+            ((NCodecInstance*)nc)->batch.read = NULL;
+        }
+
+        // Write and flush the messages (same encoding as single writes).
+        ncodec_seek(nc, 0, NCODEC_SEEK_RESET);
+        rc = ncodec_write_batch(nc, pdus, 2, sizeof(NCodecPdu));
+        assert_int_equal(rc, 2);
+        size_t len = ncodec_flush(nc);
+        assert_int_equal(len, 0x7a);
+
+        // Read the messages back (more requested than available).
+        NCodecPdu rx[4] = {};
+        ncodec_seek(nc, 0, NCODEC_SEEK_SET);
+        rc = ncodec_read_batch(nc, rx, 4, sizeof(NCodecPdu));
+        assert_int_equal(rc, 2);
+        for (int i = 0; i < 2; i++) {
+            assert_int_equal(rx[i].id, pdus[i].id);
+            assert_int_equal(rx[i].payload_len, pdus[i].payload_len);
+            assert_memory_equal(
+                rx[i].payload, pdus[i].payload, pdus[i].payload_len);
+            assert_int_equal(rx[i].swc_id, 42);
+            assert_int_equal(rx[i].ecu_id, 24);
+        }
+        rc = ncodec_read_batch(nc, rx, 4, sizeof(NCodecPdu));
+        assert_int_equal(rc, -ENOMSG);
+
+        // Guard conditions.
+        rc = ncodec_write_batch(nc, NULL, 2, sizeof(NCodecPdu));
+        assert_int_equal(rc, -EINVAL);
+        rc = ncodec_read_batch(nc, rx, 4, 0);
+        assert_int_equal(rc, -EINVAL);
+    }
+}
+
+
+static int trace_count;
+
+static void _trace(NCODEC* nc, NCodecMessage* msg)
+{
+    UNUSED(nc);
+    UNUSED(msg);
+    trace_count++;
+}
+
+void test_pdu_fbs_batch_trace(void** state)
+{
+    Mock*           mock = *state;
+    NCODEC*         nc = mock->nc;
+    NCodecInstance* _nc = (NCodecInstance*)nc;
+
+    const char* greeting = "Hello World";
+    NCodecPdu   pdus[3] = {
+        { .id = 42, .payload = (uint8_t*)greeting, .payload_len = 5 },
+        { .id = 43, .payload = NULL, .payload_len = 0 },
+        { .id = 44, .payload = (uint8_t*)greeting, .payload_len = 11 },
+    };
+    for (int i = 0; i < 3; i++) {
+        pdus[i].swc_id = 42;
+    }
+
+    // Messages are traced as with single writes/reads (i.e. when rc > 0).
+    _nc->trace.write = _trace;
+    _nc->trace.read = _trace;
+    trace_count = 0;
+    ncodec_seek(nc, 0, NCODEC_SEEK_RESET);
+    assert_int_equal(ncodec_write_batch(nc, pdus, 3, sizeof(NCodecPdu)), 3);
+    assert_int_equal(trace_count, 2);
+    ncodec_flush(nc);
+
+    trace_count = 0;
+    NCodecPdu rx[4] = {};
+    ncodec_seek(nc, 0, NCODEC_SEEK_SET);
+    assert_int_equal(ncodec_read_batch(nc, rx, 4, sizeof(NCodecPdu)), 3);
+    assert_int_equal(trace_count, 2);
+    assert_int_equal(rx[2].id, 44);
+    assert_int_equal(rx[2].payload_len, 11);
+}
+
+
 void test_pdu_fbs_readwrite_messages(void** state)
 {
     Mock*   mock = *state;
@@ -358,6 +887,60 @@ void test_pdu_fbs_readwrite_messages(void** state)
 }
 
 
+void test_pdu_fbs_message_index(void** state)
+{
+    Mock*            mock = *state;
+    NCODEC*          nc = mock->nc;
+    NCodecInstance*  _nc = (NCodecInstance*)nc;
+    ABCodecInstance* ab = (ABCodecInstance*)nc;
+    const char*      greeting = "Hello World";
+    NCodecPdu        pdu;
+
+    // Several messages, with a foreign message (other identifier).
+    uint8_t foreign[16] = { 12, 0, 0, 0, 8, 0, 0, 0, 'X', 'X', 'X', 'X' };
+    for (uint32_t id = 1; id <= 3; id++) {
+        ncodec_write(nc, &(struct NCodecPdu){ .id = id,
+                             .payload = (uint8_t*)greeting,
+                             .payload_len = strlen(greeting),
+                             .swc_id = 42 });
+        ncodec_flush(nc);
+        if (id == 1) _nc->stream->write(nc, foreign, sizeof(foreign));
+    }
+
+    // Read (builds the index), and re-read (uses the index).
+    for (int pass = 0; pass < 2; pass++) {
+        ncodec_seek(nc, 0, NCODEC_SEEK_SET);
+        for (uint32_t id = 1; id <= 3; id++) {
+            pdu = (NCodecPdu){};
+            assert_int_equal(ncodec_read(nc, &pdu), strlen(greeting));
+            assert_int_equal(pdu.id, id);
+            assert_memory_equal(pdu.payload, greeting, strlen(greeting));
+        }
+        pdu = (NCodecPdu){};
+        assert_int_equal(ncodec_read(nc, &pdu), -ENOMSG);
+        assert_int_equal(ab->msg_index.count, 4);
+        assert_int_equal(ab->msg_index.cursor, 4);
+    }
+
+    // Truncate releases the index, new content is indexed.
+    ncodec_truncate(nc);
+    assert_int_equal(ab->msg_index.count, 0);
+    assert_null(ab->msg_index.base);
+    ncodec_write(nc, &(struct NCodecPdu){ .id = 4,
+                         .payload = (uint8_t*)greeting,
+                         .payload_len = strlen(greeting),
+                         .swc_id = 42 });
+    ncodec_flush(nc);
+    ncodec_seek(nc, 0, NCODEC_SEEK_SET);
+    pdu = (NCodecPdu){};
+    assert_int_equal(ncodec_read(nc, &pdu), strlen(greeting));
+    assert_int_equal(pdu.id, 4);
+    assert_int_equal(ab->msg_index.count, 1);
+    pdu = (NCodecPdu){};
+    assert_int_equal(ncodec_read(nc, &pdu), -ENOMSG);
+}
+
+
 typedef struct can_transport_testcase {
     NCodecPduCanFrameFormat frame_format;
     NCodecPduCanFrameType   frame_type;
@@ -758,6 +1341,135 @@ void test_pdu_transport_ip__module_some_ip(void** state)
     assert_int_equal(pdu.transport.ip_message.so_ad.some_ip.return_code, 16);
 }
 
+static size_t _write_ip_pdus(NCODEC* nc, bool metadata_cache)
+{
+    const char* greeting = "Hello World";
+    NCodecPdu   pdu = {
+        .payload = (uint8_t*)greeting,
+        .payload_len = strlen(greeting),
+        .swc_id = 24,
+        .transport_type = NCodecPduTransportTypeIp,
+        .transport.ip_message = {
+            .eth_dst_mac = 0x0000123456789ABC,
+            .eth_src_mac = 0x0000CBA987654321,
+            .ip_protocol = NCodecPduIpProtocolUdp,
+            .ip_addr_type = NCodecPduIpAddrIPv4,
+            .ip_addr.ip_v4 = { .src_addr = 0x0A000001, .dst_addr = 0x0A000002 },
+            .ip_src_port = 4242,
+            .ip_dst_port = 4243,
+            .so_ad_type = NCodecPduSoAdSomeIP,
+            .so_ad.some_ip = { .message_id = 10, .length = 11 },
+        },
+    };
+
+    assert_int_equal(codec_config(nc, (struct NCodecConfigItem){
+                                          .name = "metadata_cache",
+                                          .value = metadata_cache ? "1" : "0",
+                                      }),
+        0);
+    // Identical metadata (ids 1 & 2), different metadata (id 3).
+    for (uint32_t id = 1; id <= 3; id++) {
+        pdu.id = id;
+        if (id == 3) pdu.transport.ip_message.ip_dst_port = 4244;
+        ncodec_write(nc, &pdu);
+    }
+    return ncodec_flush(nc);
+}
+
+void test_pdu_transport_ip__metadata_cache(void** state)
+{
+    Mock*   mock = *state;
+    NCODEC* nc = mock->nc;
+
+    ncodec_truncate(nc);
+    size_t len = _write_ip_pdus(nc, false);
+    ncodec_truncate(nc);
+    size_t cached_len = _write_ip_pdus(nc, true);
+    assert_true(cached_len < len);
+
+    // Next stream (the cache entries of the previous stream are invalid).
+    size_t next_len = _write_ip_pdus(nc, true);
+    assert_int_equal(next_len, cached_len);
+
+    // Read the messages back (both streams).
+    ncodec_seek(nc, 0, NCODEC_SEEK_SET);
+    for (uint32_t i = 0; i < 6; i++) {
+        NCodecPdu pdu = {};
+        assert_int_equal(ncodec_read(nc, &pdu), strlen("Hello World"));
+        assert_int_equal(pdu.id, i % 3 + 1);
+        NCodecPduIpMessageMetadata* ip = &pdu.transport.ip_message;
+        assert_int_equal(pdu.transport_type, NCodecPduTransportTypeIp);
+        assert_int_equal(ip->eth_dst_mac, 0x0000123456789ABC);
+        assert_int_equal(ip->eth_src_mac, 0x0000CBA987654321);
+        assert_int_equal(ip->ip_protocol, NCodecPduIpProtocolUdp);
+        assert_int_equal(ip->ip_addr_type, NCodecPduIpAddrIPv4);
+        assert_int_equal(ip->ip_addr.ip_v4.src_addr, 0x0A000001);
+        assert_int_equal(ip->ip_addr.ip_v4.dst_addr, 0x0A000002);
+        assert_int_equal(ip->ip_src_port, 4242);
+        assert_int_equal(ip->ip_dst_port, pdu.id == 3 ? 4244 : 4243);
+        assert_int_equal(ip->so_ad_type, NCodecPduSoAdSomeIP);
+        assert_int_equal(ip->so_ad.some_ip.message_id, 10);
+        assert_int_equal(ip->so_ad.some_ip.length, 11);
+    }
+    NCodecPdu pdu = {};
+    assert_int_equal(ncodec_read(nc, &pdu), -ENOMSG);
+}
+
+
+void test_pdu_transport_ip__decode_cache(void** state)
+{
+    Mock*            mock = *state;
+    NCODEC*          nc = mock->nc;
+    ABCodecInstance* ab = (ABCodecInstance*)nc;
+    const char*      greeting = "Hello World";
+    NCodecPdu        pdu = {
+        .id = 42,
+        .payload = (uint8_t*)greeting,
+        .payload_len = strlen(greeting),
+        .swc_id = 24,
+        .transport_type = NCodecPduTransportTypeIp,
+        .transport.ip_message = { .ip_src_port = 4242, .ip_dst_port = 4243 },
+    };
+
+    // Read twice (the cache is scoped to the message being parsed).
+    ncodec_truncate(nc);
+    ncodec_write(nc, &pdu);
+    ncodec_flush(nc);
+    for (int i = 0; i < 2; i++) {
+        ncodec_seek(nc, 0, NCODEC_SEEK_SET);
+        NCodecPdu msg = {};
+        assert_int_equal(ncodec_read(nc, &msg), strlen(greeting));
+        assert_int_equal(msg.transport_type, NCodecPduTransportTypeIp);
+        assert_int_equal(msg.transport.ip_message.ip_src_port, 4242);
+        assert_int_equal(msg.transport.ip_message.ip_dst_port, 4243);
+    }
+    assert_non_null(ab->decode_cache);
+
+    // New content, the transport table has the same address.
+    ncodec_truncate(nc);
+    pdu.transport.ip_message.ip_dst_port = 5000;
+    ncodec_write(nc, &pdu);
+    ncodec_flush(nc);
+    ncodec_seek(nc, 0, NCODEC_SEEK_SET);
+    NCodecPdu msg = {};
+    assert_int_equal(ncodec_read(nc, &msg), strlen(greeting));
+    assert_int_equal(msg.transport.ip_message.ip_src_port, 4242);
+    assert_int_equal(msg.transport.ip_message.ip_dst_port, 5000);
+
+    // Stream reset (no truncate, the message index is retained) and content
+    // of the same size rewritten at the same address.
+    ncodec_seek(nc, 0, NCODEC_SEEK_RESET);
+    pdu.transport.ip_message.ip_dst_port = 6000;
+    ncodec_write(nc, &pdu);
+    ncodec_flush(nc);
+    ncodec_seek(nc, 0, NCODEC_SEEK_SET);
+    msg = (NCodecPdu){};
+    assert_int_equal(ncodec_read(nc, &msg), strlen(greeting));
+    assert_int_equal(msg.transport.ip_message.ip_src_port, 4242);
+    assert_int_equal(msg.transport.ip_message.ip_dst_port, 6000);
+}
+
+
 void test_pdu_transport_struct(void** state)
 {
     Mock*   mock = *state;
@@ -835,6 +1547,198 @@ void test_pdu_transport_struct(void** state)
 }
 
 
+void test_pdu_transport_struct_intern(void** state)
+{
+    Mock*   mock = *state;
+    NCODEC* nc = mock->nc;
+
+    const char* greeting = "Hello World";
+    char        type_name[2][8] = { "foo", "foo" };
+    NCodecPdu   pdu = {
+        .payload = (uint8_t*)greeting,
+        .payload_len = strlen(greeting),
+        .swc_id = 42,
+        .transport_type = NCodecPduTransportTypeStruct,
+        .transport.struct_object = {
+            .var_name = "bar",
+            .encoding = "foobar",
+            .platform_arch = "amd64",
+            .platform_os = "linux",
+        },
+    };
+
+    // Distinct strings (same length), each string is emitted.
+    ncodec_truncate(nc);
+    strcpy(type_name[1], "baz");
+    for (uint32_t i = 0; i < 2; i++) {
+        pdu.id = 42 + i;
+        pdu.transport.struct_object.type_name = type_name[i];
+        ncodec_write(nc, &pdu);
+    }
+    size_t distinct_len = ncodec_flush(nc);
+
+    // Identical strings (in different objects), strings are referenced.
+    ncodec_truncate(nc);
+    strcpy(type_name[1], "foo");
+    for (uint32_t i = 0; i < 2; i++) {
+        pdu.id = 42 + i;
+        pdu.transport.struct_object.type_name = type_name[i];
+        ncodec_write(nc, &pdu);
+    }
+    size_t interned_len = ncodec_flush(nc);
+    assert_true(interned_len < distinct_len);
+
+    // Modify the string after the write, the next stream is not affected.
+    strcpy(type_name[0], "qux");
+    pdu.id = 44;
+    pdu.transport.struct_object.type_name = type_name[0];
+    ncodec_write(nc, &pdu);
+    ncodec_flush(nc);
+
+    // Read the messages back.
+    const char* expect[] = { "foo", "foo", "qux" };
+    ncodec_seek(nc, 0, NCODEC_SEEK_SET);
+    for (uint32_t i = 0; i < ARRAY_SIZE(expect); i++) {
+        pdu = (NCodecPdu){};
+        assert_int_equal(ncodec_read(nc, &pdu), strlen(greeting));
+        assert_int_equal(pdu.id, 42 + i);
+        assert_int_equal(pdu.transport_type, NCodecPduTransportTypeStruct);
+        assert_string_equal(pdu.transport.struct_object.type_name, expect[i]);
+        assert_string_equal(pdu.transport.struct_object.var_name, "bar");
+        assert_string_equal(pdu.transport.struct_object.encoding, "foobar");
+        assert_string_equal(pdu.transport.struct_object.platform_arch, "amd64");
+        assert_string_equal(pdu.transport.struct_object.platform_os, "linux");
+        assert_null(pdu.transport.struct_object.platform_abi);
+    }
+}
+
+
+void test_pdu_transport_lazy(void** state)
+{
+    Mock*   mock = *state;
+    NCODEC* nc = mock->nc;
+    int     rc;
+
+    const char* greeting = "Hello World";
+    NCodecPdu   pdus[] = {
+        {
+            .id = 1,
+            .transport_type = NCodecPduTransportTypeIp,
+            .transport.ip_message = {
+                .eth_dst_mac = 0x0000123456789ABC,
+                .ip_protocol = NCodecPduIpProtocolUdp,
+                .ip_addr_type = NCodecPduIpAddrIPv6,
+                .ip_addr.ip_v6 = {
+                    .src_addr = { 1, 2, 3, 4, 5, 6, 7, 8 },
+                    .dst_addr = { 2, 2, 4, 4, 6, 6, 8, 8 },
+                },
+                .ip_src_port = 4003,
+                .so_ad_type = NCodecPduSoAdSomeIP,
+                .so_ad.some_ip = { .message_id = 42, .request_id = 24 },
+            },
+        },
+        {
+            .id = 2,
+            .transport_type = NCodecPduTransportTypeCan,
+            .transport.can_message = { .frame_type = 1, .interface_id = 3 },
+        },
+        {
+            .id = 3,
+            .transport_type = NCodecPduTransportTypeStruct,
+            .transport.struct_object = { .type_name = "foo",
+                .attribute_aligned = 8 },
+        },
+        { .id = 4 },
+    };
+    ncodec_truncate(nc);
+    for (size_t i = 0; i < ARRAY_SIZE(pdus); i++) {
+        pdus[i].swc_id = 44;
+        pdus[i].payload = (uint8_t*)greeting;
+        pdus[i].payload_len = strlen(greeting);
+        rc = ncodec_write(nc, &pdus[i]);
+        assert_int_equal(rc, strlen(greeting));
+    }
+    ncodec_flush(nc);
+
+    /* Eager decode (reference). */
+    NCodecPdu eager[ARRAY_SIZE(pdus)] = {};
+    ncodec_seek(nc, 0, NCODEC_SEEK_SET);
+    for (size_t i = 0; i < ARRAY_SIZE(pdus); i++) {
+        rc = ncodec_read(nc, &eager[i]);
+        assert_int_equal(rc, strlen(greeting));
+        assert_int_equal(ab_pdu_transport(nc, &eager[i]), 0);
+    }
+    assert_int_equal(eager[0].transport.ip_message.so_ad.some_ip.message_id, 42);
+
+    /* Lazy decode, metadata is decoded on demand. */
+    ncodec_config(nc, (struct NCodecConfigItem){
+                          .name = "decode",
+                          .value = "lazy",
+                      });
+    ncodec_seek(nc, 0, NCODEC_SEEK_SET);
+    for (size_t i = 0; i < ARRAY_SIZE(pdus); i++) {
+        NCodecPdu pdu = {};
+        rc = ncodec_read(nc, &pdu);
+        assert_int_equal(rc, strlen(greeting));
+        assert_int_equal(pdu.id, pdus[i].id);
+        assert_memory_equal(pdu.payload, greeting, strlen(greeting));
+        assert_int_equal(pdu.transport_type, pdus[i].transport_type);
+        if (pdu.transport_type == NCodecPduTransportTypeIp) {
+            assert_int_equal(pdu.transport.ip_message.ip_src_port, 0);
+        }
+        assert_int_equal(ab_pdu_transport(nc, &pdu), 0);
+        assert_memory_equal(
+            &pdu.transport, &eager[i].transport, sizeof(pdu.transport));
+        /* Second call, nothing pending, the PDU is not modified. */
+        assert_int_equal(ab_pdu_transport(nc, &pdu), 0);
+        assert_memory_equal(
+            &pdu.transport, &eager[i].transport, sizeof(pdu.transport));
+    }
+    assert_int_equal(ncodec_read(nc, &(NCodecPdu){}), -ENOMSG);
+
+    /* Forward a lazily read PDU (a copy of the PDU object is decoded). */
+    ncodec_seek(nc, 0, NCODEC_SEEK_SET);
+    NCodecPdu read = {};
+    assert_int_equal(ncodec_read(nc, &read), strlen(greeting));
+    assert_int_equal(read.transport_type, NCodecPduTransportTypeIp);
+    NCodecPdu fwd = read;
+    NCODEC*   fwd_nc =
+        (void*)ncodec_open(MIMETYPE, ncodec_buffer_stream_create(0));
+    assert_non_null(fwd_nc);
+    assert_int_equal(ab_pdu_transport(nc, &fwd), 0);
+    assert_int_equal(ncodec_write(fwd_nc, &fwd), strlen(greeting));
+    ncodec_flush(fwd_nc);
+    ncodec_seek(fwd_nc, 0, NCODEC_SEEK_SET);
+    NCodecPdu fwd_read = {};
+    assert_int_equal(ncodec_read(fwd_nc, &fwd_read), strlen(greeting));
+    assert_int_equal(fwd_read.id, pdus[0].id);
+    assert_memory_equal(
+        &fwd_read.transport, &eager[0].transport, sizeof(fwd_read.transport));
+    ncodec_close(fwd_nc);
+
+    /* PDUs read before the stream is truncated are no longer pending. */
+    ncodec_seek(nc, 0, NCODEC_SEEK_SET);
+    assert_int_equal(ncodec_read(nc, &read), strlen(greeting));
+    assert_int_equal(ncodec_read(nc, &fwd), strlen(greeting));
+    assert_true(((ABCodecInstance*)nc)->decode_pending.count >= 2);
+    ncodec_truncate(nc);
+    assert_int_equal(((ABCodecInstance*)nc)->decode_pending.count, 0);
+    assert_int_equal(ab_pdu_transport(nc, &read), 0);
+    assert_int_equal(read.transport.ip_message.ip_src_port, 0);
+
+    /* Errors. */
+    NCodecPdu pdu = { .transport_type = NCodecPduTransportTypeIp };
+    assert_int_equal(ab_pdu_transport(nc, &pdu), 0);
+    assert_int_equal(ab_pdu_transport(nc, NULL), -EINVAL);
+    assert_int_equal(ab_pdu_transport(NULL, &pdu), -ENOSTR);
+    assert_int_equal(codec_config(nc, (struct NCodecConfigItem){
+                                          .name = "decode",
+                                          .value = "foo",
+                                      }),
+        -EINVAL);
+}
+
+
 int run_pdu_fbs_tests(void)
 {
     void* s = test_setup;
@@ -844,12 +1748,23 @@ int run_pdu_fbs_tests(void)
         cmocka_unit_test_setup_teardown(test_pdu_fbs_no_stream, s, t),
         cmocka_unit_test_setup_teardown(test_pdu_fbs_no_payload, s, t),
         cmocka_unit_test_setup_teardown(test_pdu_fbs_flush, s, t),
+        cmocka_unit_test_setup_teardown(test_pdu_fbs_flush_large, s, t),
+        cmocka_unit_test_setup_teardown(test_pdu_fbs_flush_reserve, s, t),
+        cmocka_unit_test_setup_teardown(test_pdu_fbs_flush_failed, s, t),
         cmocka_unit_test_setup_teardown(test_pdu_fbs_read_nomsg, s, t),
         cmocka_unit_test_setup_teardown(test_pdu_fbs_write, s, t),
         cmocka_unit_test_setup_teardown(test_pdu_fbs_readwrite, s, t),
         cmocka_unit_test_setup_teardown(test_pdu_fbs_truncate, s, t),
         cmocka_unit_test_setup_teardown(test_pdu_fbs_readwrite_pdus, s, t),
         cmocka_unit_test_setup_teardown(test_pdu_fbs_readwrite_messages, s, t),
+        cmocka_unit_test_setup_teardown(test_pdu_fbs_readwrite_batch, s, t),
+        cmocka_unit_test_setup_teardown(test_pdu_fbs_batch_trace, s, t),
+        cmocka_unit_test_setup_teardown(test_pdu_fbs_ring_stream, s, t),
+        cmocka_unit_test_setup_teardown(test_pdu_fbs_ring_stream_write, s, t),
+        cmocka_unit_test_setup_teardown(test_pdu_fbs_sender_index, s, t),
+        cmocka_unit_test_setup_teardown(
+            test_pdu_fbs_sender_index_marker, s, t),
+        cmocka_unit_test_setup_teardown(test_pdu_fbs_message_index, s, t),
         cmocka_unit_test_setup_teardown(test_pdu_transport_can, s, t),
         cmocka_unit_test_setup_teardown(test_pdu_transport_ip__eth, s, t),
         cmocka_unit_test_setup_teardown(test_pdu_transport_ip__ip, s, t),
@@ -857,7 +1772,14 @@ int run_pdu_fbs_tests(void)
             test_pdu_transport_ip__module_do_ad, s, t),
         cmocka_unit_test_setup_teardown(
             test_pdu_transport_ip__module_some_ip, s, t),
+        cmocka_unit_test_setup_teardown(
+            test_pdu_transport_ip__metadata_cache, s, t),
+        cmocka_unit_test_setup_teardown(
+            test_pdu_transport_ip__decode_cache, s, t),
         cmocka_unit_test_setup_teardown(test_pdu_transport_struct, s, t),
+        cmocka_unit_test_setup_teardown(
+            test_pdu_transport_struct_intern, s, t),
+        cmocka_unit_test_setup_teardown(test_pdu_transport_lazy, s, t),
     };
 
     return cmocka_run_group_tests_name("PDU FBS", pdu_fbs_tests, NULL, NULL);
@@ -0,0 +1,25 @@
+// Copyright 2025 Robert Bosch GmbH
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#include <dse/testing.h>
+
+extern int run_buffer_tests(void);
+extern int run_ring_tests(void);
+extern int run_shm_tests(void);
+extern int run_file_tests(void);
+extern int run_ascii85_tests(void);
+extern int run_transport_tests(void);
+
+
+int main()
+{
+    int rc = 0;
+    rc |= run_buffer_tests();
+    rc |= run_ring_tests();
+    rc |= run_shm_tests();
+    rc |= run_file_tests();
+    rc |= run_ascii85_tests();
+    rc |= run_transport_tests();
+    return rc;
+}
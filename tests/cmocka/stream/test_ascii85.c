@@ -0,0 +1,217 @@
+// Copyright 2025 Robert Bosch GmbH
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#include <dse/testing.h>
+#include <errno.h>
+#include <stdio.h>
+#include <string.h>
+#include <dse/ncodec/stream/stream.h>
+
+
+#define UNUSED(x)     ((void)x)
+#define ARRAY_SIZE(x) (sizeof(x) / sizeof(x[0]))
+
+
+extern int ascii85_select_isa(int isa);
+
+
+/* Reference (scalar) implementation, the original ascii85 encoder. */
+static char* _ref_encode(const char* source, size_t source_len)
+{
+    int required = (source_len + 3) / 4 * 5;
+    int padding = (source_len % 4) ? 4 - (source_len % 4) : 0;
+
+    char* en = calloc(required + 1, sizeof(char));
+    char* en_save = en;
+    while (source_len) {
+        uint32_t x = 0;
+        for (int chunk = 3; chunk >= 0; chunk--) {
+            x |= (uint32_t)(uint8_t)*source << (chunk * 8);
+            source++;
+            if (--source_len == 0) break;
+        }
+        if (x == 0 && source_len >= 4) {
+            en[0] = 'z';
+            en += 1;
+            continue;
+        }
+        for (int byte = 4; byte >= 0; byte--) {
+            en[byte] = (x % 85) + 33;
+            x /= 85;
+        }
+        en += 5;
+    }
+    for (int i = 1; i <= padding; i++) {
+        en_save[strlen(en_save) - 1] = '\0';
+    }
+    return en_save;
+}
+
+
+static void _fill(uint8_t* data, size_t len, unsigned int seed)
+{
+    srand(seed);
+    for (size_t i = 0; i < len; i++) {
+        data[i] = rand() & 0xff;
+    }
+    /* Zero runs, so that some groups are encoded as 'z'. */
+    for (size_t i = 0; i < len / 16; i++) {
+        size_t offset = rand() % len;
+        size_t run = 4 + rand() % 12;
+        if (offset + run > len) run = len - offset;
+        memset(data + offset, 0, run);
+    }
+}
+
+
+void test_ascii85_reference(void** state)
+{
+    UNUSED(state);
+    uint8_t data[600];
+    uint8_t zeros[600] = { 0 };
+
+    int max_isa = ascii85_select_isa(99);
+    for (int isa = 0; isa <= max_isa; isa++) {
+        assert_int_equal(ascii85_select_isa(isa), isa);
+        for (size_t len = 0; len < sizeof(data); len++) {
+            _fill(data, len, len);
+            for (int z = 0; z < 2; z++) {
+                const char* source = z ? (char*)zeros : (char*)data;
+                char*       ref = _ref_encode(source, len);
+                char*       en = ascii85_encode(source, len);
+                assert_non_null(en);
+                assert_string_equal(en, ref);
+                assert_true(strlen(en) <= ascii85_encode_len(len));
+
+                size_t de_len = 0;
+                char*  de = ascii85_decode(en, &de_len);
+                assert_non_null(de);
+                assert_int_equal(de_len, len);
+                assert_int_equal(ascii85_decode_len(en, strlen(en)), len);
+                assert_memory_equal(de, source, len);
+                free(de);
+                free(en);
+                free(ref);
+            }
+        }
+    }
+    ascii85_select_isa(99);
+}
+
+
+void test_ascii85_into(void** state)
+{
+    UNUSED(state);
+    uint8_t data[100];
+    char    en[200];
+    uint8_t de[200];
+    _fill(data, sizeof(data), 42);
+    memset(data + 8, 0, 8);
+
+    int max_isa = ascii85_select_isa(99);
+    for (int isa = 0; isa <= max_isa; isa++) {
+        ascii85_select_isa(isa);
+        /* Encode, exact capacity (no null terminator). */
+        int64_t en_len = ascii85_encode_into(data, sizeof(data), en, sizeof(en));
+        assert_true(en_len > 0);
+        assert_int_equal(en[en_len], '\0');
+        assert_true((size_t)en_len < ascii85_encode_len(sizeof(data)));
+        char exact[200];
+        assert_int_equal(
+            ascii85_encode_into(data, sizeof(data), exact, en_len), en_len);
+        assert_memory_equal(exact, en, en_len);
+        assert_int_equal(ascii85_encode_into(data, sizeof(data), exact, en_len - 1),
+            -EMSGSIZE);
+        assert_int_equal(ascii85_encode_into(data, 0, exact, 0), 0);
+
+        /* Decode, exact capacity. */
+        assert_int_equal(
+            ascii85_decode_into(en, en_len, de, sizeof(data)), sizeof(data));
+        assert_memory_equal(de, data, sizeof(data));
+        assert_int_equal(ascii85_decode_into(en, en_len, de, sizeof(data) - 1),
+            -EMSGSIZE);
+        assert_int_equal(ascii85_decode_into(en, 0, de, 0), 0);
+    }
+    ascii85_select_isa(99);
+}
+
+
+void test_ascii85_streaming(void** state)
+{
+    UNUSED(state);
+    uint8_t data[600];
+    char    en[800];
+    uint8_t de[600];
+    size_t  chunks[] = { 1, 2, 3, 4, 5, 7, 8, 9, 13, 64, 1000 };
+
+    int max_isa = ascii85_select_isa(99);
+    for (int isa = 0; isa <= max_isa; isa++) {
+        ascii85_select_isa(isa);
+        for (size_t len = 0; len < sizeof(data); len += 7) {
+            _fill(data, len, len);
+            char* ref = ascii85_encode((char*)data, len);
+            for (size_t c = 0; c < ARRAY_SIZE(chunks); c++) {
+                /* Encode, in chunks. */
+                Ascii85Encoder encoder;
+                ascii85_encoder_init(&encoder);
+                size_t en_len = 0;
+                for (size_t i = 0; i < len; i += chunks[c]) {
+                    size_t  n = (len - i < chunks[c]) ? len - i : chunks[c];
+                    int64_t rc = ascii85_encoder_update(&encoder, data + i, n,
+                        en + en_len, sizeof(en) - en_len);
+                    assert_true(rc >= 0);
+                    en_len += rc;
+                }
+                int64_t rc = ascii85_encoder_final(
+                    &encoder, en + en_len, sizeof(en) - en_len);
+                assert_true(rc >= 0);
+                en_len += rc;
+                assert_int_equal(en_len, strlen(ref));
+                assert_string_equal(en, ref);
+
+                /* Decode, in chunks. */
+                Ascii85Decoder decoder;
+                ascii85_decoder_init(&decoder);
+                size_t de_len = 0;
+                for (size_t i = 0; i < en_len; i += chunks[c]) {
+                    size_t n = (en_len - i < chunks[c]) ? en_len - i : chunks[c];
+                    rc = ascii85_decoder_update(&decoder, en + i, n,
+                        de + de_len, sizeof(de) - de_len);
+                    assert_true(rc >= 0);
+                    de_len += rc;
+                }
+                rc = ascii85_decoder_final(
+                    &decoder, de + de_len, sizeof(de) - de_len);
+                assert_true(rc >= 0);
+                de_len += rc;
+                assert_int_equal(de_len, len);
+                assert_memory_equal(de, data, len);
+            }
+            free(ref);
+        }
+    }
+    ascii85_select_isa(99);
+
+    /* Insufficient capacity, nothing is encoded. */
+    Ascii85Encoder encoder;
+    ascii85_encoder_init(&encoder);
+    assert_int_equal(
+        ascii85_encoder_update(&encoder, data, 100, en, 10), -EMSGSIZE);
+    assert_int_equal(encoder.len, 0);
+}
+
+
+int run_ascii85_tests(void)
+{
+    void* s = NULL;
+    void* t = NULL;
+
+    const struct CMUnitTest ascii85_tests[] = {
+        cmocka_unit_test_setup_teardown(test_ascii85_reference, s, t),
+        cmocka_unit_test_setup_teardown(test_ascii85_into, s, t),
+        cmocka_unit_test_setup_teardown(test_ascii85_streaming, s, t),
+    };
+
+    return cmocka_run_group_tests_name("ASCII85", ascii85_tests, NULL, NULL);
+}
@@ -0,0 +1,191 @@
+// Copyright 2025 Robert Bosch GmbH
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#include <dse/testing.h>
+#include <errno.h>
+#include <stdio.h>
+#include <dse/ncodec/codec.h>
+#include <dse/ncodec/stream/stream.h>
+
+
+#define UNUSED(x)     ((void)x)
+#define ARRAY_SIZE(x) (sizeof(x) / sizeof(x[0]))
+
+
+typedef struct Mock {
+    NCodecInstance      nc;
+    NCodecStreamVTable* stream;
+} Mock;
+
+
+static int test_setup(void** state)
+{
+    Mock* mock = calloc(1, sizeof(Mock));
+    assert_non_null(mock);
+
+    mock->stream = ncodec_buffer_stream_create(0);
+    mock->nc.stream = mock->stream;
+    mock->nc.stream_ext = ncodec_stream_ext(mock->stream);
+    assert_non_null(mock->stream);
+
+    *state = mock;
+    return 0;
+}
+
+
+static int test_teardown(void** state)
+{
+    Mock* mock = *state;
+    if (mock && mock->nc.stream) mock->stream->close((void*)&mock->nc);
+    if (mock) free(mock);
+
+    return 0;
+}
+
+
+void test_buffer_growth(void** state)
+{
+    Mock*   mock = *state;
+    NCODEC* nc = (void*)&mock->nc;
+
+    uint8_t data[100];
+    for (uint32_t i = 0; i < sizeof(data); i++)
+        data[i] = i;
+
+    /* Many small writes, content is retained as the buffer grows. */
+    for (uint32_t i = 0; i < 100; i++) {
+        size_t rc = mock->stream->write(nc, data, sizeof(data));
+        assert_int_equal(rc, sizeof(data));
+    }
+    assert_int_equal(mock->stream->tell(nc), 100 * sizeof(data));
+    assert_int_equal(ncodec_buffer_stream_hwm(mock->stream), 100 * sizeof(data));
+
+    mock->stream->seek(nc, 0, NCODEC_SEEK_SET);
+    uint8_t* buffer;
+    size_t   len;
+    mock->stream->read(nc, &buffer, &len, NCODEC_POS_NC);
+    assert_int_equal(len, 100 * sizeof(data));
+    for (uint32_t i = 0; i < 100; i++) {
+        assert_memory_equal(&buffer[i * sizeof(data)], data, sizeof(data));
+    }
+}
+
+
+void test_buffer_reserve(void** state)
+{
+    Mock*   mock = *state;
+    NCODEC* nc = (void*)&mock->nc;
+    int32_t rc;
+
+    /* Presize the buffer, writes within the capacity do not move it. */
+    rc = ncodec_buffer_stream_reserve(mock->stream, 4096);
+    assert_int_equal(rc, 0);
+
+    uint8_t* data;
+    rc = mock->nc.stream_ext->reserve(nc, 100, &data);
+    assert_int_equal(rc, 0);
+    uint8_t* buffer = data;
+    memset(data, 0x55, 100);
+    rc = mock->nc.stream_ext->commit(nc, 100);
+    assert_int_equal(rc, 100);
+    for (uint32_t i = 0; i < 39; i++) {
+        rc = mock->stream->write(nc, data, 100);
+        assert_int_equal(rc, 100);
+    }
+    mock->stream->seek(nc, 0, NCODEC_SEEK_SET);
+    size_t len;
+    mock->stream->read(nc, &data, &len, NCODEC_POS_NC);
+    assert_ptr_equal(data, buffer);
+    assert_int_equal(len, 4000);
+
+    /* Commit beyond the reserved region. */
+    mock->stream->seek(nc, 0, NCODEC_SEEK_END);
+    rc = mock->nc.stream_ext->commit(nc, 4096);
+    assert_int_equal(rc, -EINVAL);
+}
+
+
+void test_buffer_shrink_to_fit(void** state)
+{
+    Mock*   mock = *state;
+    NCODEC* nc = (void*)&mock->nc;
+
+    uint8_t data[1000] = {};
+    mock->stream->write(nc, data, sizeof(data));
+    mock->stream->write(nc, data, sizeof(data));
+    assert_int_equal(ncodec_buffer_stream_shrink_to_fit(mock->stream), 2000);
+
+    /* Truncate, then release all capacity; the high-water mark remains. */
+    mock->stream->seek(nc, 0, NCODEC_SEEK_RESET);
+    assert_int_equal(ncodec_buffer_stream_shrink_to_fit(mock->stream), 0);
+    assert_int_equal(ncodec_buffer_stream_hwm(mock->stream), 2000);
+
+    /* Stream remains usable. */
+    size_t rc = mock->stream->write(nc, data, sizeof(data));
+    assert_int_equal(rc, sizeof(data));
+    assert_int_equal(mock->stream->tell(nc), sizeof(data));
+}
+
+
+void test_buffer_max(void** state)
+{
+    Mock*   mock = *state;
+    NCODEC* nc = (void*)&mock->nc;
+    int32_t rc;
+
+    rc = ncodec_buffer_stream_set_max(mock->stream, 1024);
+    assert_int_equal(rc, 0);
+
+    uint8_t data[1000] = {};
+    rc = mock->stream->write(nc, data, sizeof(data));
+    assert_int_equal(rc, sizeof(data));
+    rc = mock->stream->write(nc, data, sizeof(data));
+    assert_int_equal(rc, -EMSGSIZE);
+    assert_int_equal(mock->stream->tell(nc), sizeof(data));
+    rc = ncodec_buffer_stream_reserve(mock->stream, 2048);
+    assert_int_equal(rc, -EMSGSIZE);
+    uint8_t* ptr;
+    rc = mock->nc.stream_ext->reserve(nc, 25, &ptr);
+    assert_int_equal(rc, -EMSGSIZE);
+    assert_null(ptr);
+}
+
+
+void test_buffer_fixed(void** state)
+{
+    UNUSED(state);
+    int32_t rc;
+
+    NCodecInstance nc = { .stream = ncodec_buffer_stream_create(64) };
+    uint8_t        data[48] = {};
+
+    rc = nc.stream->write((void*)&nc, data, sizeof(data));
+    assert_int_equal(rc, sizeof(data));
+    rc = nc.stream->write((void*)&nc, data, sizeof(data));
+    assert_int_equal(rc, -EMSGSIZE);
+    rc = ncodec_buffer_stream_reserve(nc.stream, 128);
+    assert_int_equal(rc, -EMSGSIZE);
+    rc = ncodec_buffer_stream_set_max(nc.stream, 128);
+    assert_int_equal(rc, -EINVAL);
+    assert_int_equal(ncodec_buffer_stream_shrink_to_fit(nc.stream), 64);
+
+    nc.stream->close((void*)&nc);
+}
+
+
+int run_buffer_tests(void)
+{
+    void* s = test_setup;
+    void* t = test_teardown;
+
+    const struct CMUnitTest buffer_tests[] = {
+        cmocka_unit_test_setup_teardown(test_buffer_growth, s, t),
+        cmocka_unit_test_setup_teardown(test_buffer_reserve, s, t),
+        cmocka_unit_test_setup_teardown(test_buffer_shrink_to_fit, s, t),
+        cmocka_unit_test_setup_teardown(test_buffer_max, s, t),
+        cmocka_unit_test_setup_teardown(test_buffer_fixed, s, t),
+    };
+
+    return cmocka_run_group_tests_name("BUFFER", buffer_tests, NULL, NULL);
+}
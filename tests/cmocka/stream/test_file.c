@@ -0,0 +1,200 @@
+// Copyright 2025 Robert Bosch GmbH
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#include <dse/testing.h>
+#include <errno.h>
+#include <stdio.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <dse/ncodec/codec.h>
+#include <dse/ncodec/stream/stream.h>
+
+
+#define UNUSED(x)     ((void)x)
+#define ARRAY_SIZE(x) (sizeof(x) / sizeof(x[0]))
+
+
+typedef struct Mock {
+    char path[64];
+} Mock;
+
+
+static int test_setup(void** state)
+{
+    Mock* mock = calloc(1, sizeof(Mock));
+    assert_non_null(mock);
+
+    snprintf(mock->path, sizeof(mock->path), "/tmp/ncodec.test.%d", getpid());
+
+    *state = mock;
+    return 0;
+}
+
+
+static int test_teardown(void** state)
+{
+    Mock* mock = *state;
+    if (mock) unlink(mock->path);
+    if (mock) free(mock);
+
+    return 0;
+}
+
+
+void test_file_record_replay(void** state)
+{
+    Mock*   mock = *state;
+    int32_t rc;
+
+    uint8_t msg[1000];
+    for (uint32_t i = 0; i < sizeof(msg); i++)
+        msg[i] = i;
+
+    /* Record, more content than the initial chunk. */
+    NCodecInstance rec = { .stream =
+                               ncodec_file_stream_create(mock->path, "w") };
+    assert_non_null(rec.stream);
+    uint8_t* first = NULL;
+    size_t   first_len;
+    for (uint32_t i = 0; i < 2000; i++) {
+        msg[0] = i;
+        rc = rec.stream->write((void*)&rec, msg, sizeof(msg));
+        assert_int_equal(rc, sizeof(msg));
+        if (i == 0) {
+            rec.stream->seek((void*)&rec, 0, NCODEC_SEEK_SET);
+            rec.stream->read(
+                (void*)&rec, &first, &first_len, NCODEC_POS_UPDATE);
+            assert_int_equal(first_len, sizeof(msg));
+        }
+    }
+    assert_int_equal(rec.stream->tell((void*)&rec), 2000 * sizeof(msg));
+    /* Pointers into the stream remain valid as the file grows. */
+    uint8_t* buffer;
+    size_t   len;
+    rec.stream->seek((void*)&rec, 0, NCODEC_SEEK_SET);
+    rec.stream->read((void*)&rec, &buffer, &len, NCODEC_POS_NC);
+    assert_ptr_equal(buffer, first);
+    assert_memory_equal(&first[1], &msg[1], sizeof(msg) - 1);
+    rec.stream->close((void*)&rec);
+    struct stat st;
+    stat(mock->path, &st);
+    assert_int_equal(st.st_size, 2000 * sizeof(msg));
+
+    /* Replay, reads reference the mapped file. */
+    NCodecInstance rep = { .stream =
+                               ncodec_file_stream_create(mock->path, "r") };
+    assert_non_null(rep.stream);
+    rc = rep.stream->read((void*)&rep, &buffer, &len, NCODEC_POS_NC);
+    assert_int_equal(len, 2000 * sizeof(msg));
+    for (uint32_t i = 0; i < 2000; i++) {
+        assert_int_equal(buffer[i * sizeof(msg)], i & 0xff);
+        assert_memory_equal(&buffer[i * sizeof(msg) + 1], &msg[1], 999);
+    }
+    /* Replay content is not truncated, or written. */
+    rep.stream->seek((void*)&rep, 0, NCODEC_SEEK_RESET);
+    assert_int_equal(rep.stream->eof((void*)&rep), 0);
+    rc = rep.stream->write((void*)&rep, msg, sizeof(msg));
+    assert_int_equal(rc, -EPERM);
+    rep.stream->close((void*)&rep);
+}
+
+
+void test_file_record_steps(void** state)
+{
+    Mock*    mock = *state;
+    int32_t  rc;
+    uint8_t* buffer;
+    size_t   len;
+    char     msg[8];
+
+    /* Record several steps, each step resets the stream. */
+    NCodecInstance rec = { .stream =
+                               ncodec_file_stream_create(mock->path, "w") };
+    assert_non_null(rec.stream);
+    for (uint32_t i = 0; i < 4; i++) {
+        if (i == 2) {
+            /* Continue the recording (append). */
+            rec.stream->close((void*)&rec);
+            rec.stream = ncodec_file_stream_create(mock->path, "a");
+            assert_non_null(rec.stream);
+        }
+        rec.stream->seek((void*)&rec, 0, NCODEC_SEEK_RESET);
+        assert_int_equal(rec.stream->tell((void*)&rec), 0);
+        snprintf(msg, sizeof(msg), "step%02u", i);
+        rc = rec.stream->write((void*)&rec, (uint8_t*)msg, 6);
+        assert_int_equal(rc, 6);
+        assert_int_equal(rec.stream->tell((void*)&rec), 6);
+
+        /* Only the content of this step is visible. */
+        assert_int_equal(rec.stream->seek((void*)&rec, 0, NCODEC_SEEK_SET), 0);
+        rec.stream->read((void*)&rec, &buffer, &len, NCODEC_POS_UPDATE);
+        assert_int_equal(len, 6);
+        assert_memory_equal(buffer, msg, 6);
+        assert_int_equal(rec.stream->eof((void*)&rec), 1);
+    }
+    rec.stream->close((void*)&rec);
+
+    /* Replay, all steps were recorded. */
+    NCodecInstance rep = { .stream =
+                               ncodec_file_stream_create(mock->path, "r") };
+    assert_non_null(rep.stream);
+    rep.stream->read((void*)&rep, &buffer, &len, NCODEC_POS_UPDATE);
+    assert_int_equal(len, 24);
+    assert_memory_equal(buffer, "step00step01step02step03", 24);
+    rep.stream->close((void*)&rep);
+}
+
+
+void test_file_append(void** state)
+{
+    Mock*   mock = *state;
+    int32_t rc;
+
+    NCodecInstance nc = { .stream = ncodec_file_stream_create(mock->path, "w") };
+    assert_non_null(nc.stream);
+    rc = nc.stream->write((void*)&nc, (uint8_t*)"hello", 5);
+    assert_int_equal(rc, 5);
+    nc.stream->close((void*)&nc);
+
+    nc.stream = ncodec_file_stream_create(mock->path, "a");
+    assert_non_null(nc.stream);
+    assert_int_equal(nc.stream->tell((void*)&nc), 5);
+    nc.stream_ext = ncodec_stream_ext(nc.stream);
+    assert_int_equal(nc.stream_ext->size, sizeof(NCodecStreamExtVTable));
+    uint8_t* data;
+    rc = nc.stream_ext->reserve((void*)&nc, 5, &data);
+    assert_int_equal(rc, 0);
+    memcpy(data, "world", 5);
+    rc = nc.stream_ext->commit((void*)&nc, 5);
+    assert_int_equal(rc, 5);
+    nc.stream->close((void*)&nc);
+
+    nc.stream = ncodec_file_stream_create(mock->path, "r");
+    assert_non_null(nc.stream);
+    uint8_t* buffer;
+    size_t   len;
+    nc.stream->read((void*)&nc, &buffer, &len, NCODEC_POS_UPDATE);
+    assert_int_equal(len, 10);
+    assert_memory_equal(buffer, "helloworld", 10);
+    assert_int_equal(nc.stream->eof((void*)&nc), 1);
+    nc.stream->close((void*)&nc);
+
+    assert_null(ncodec_file_stream_create(mock->path, "x"));
+    assert_null(ncodec_file_stream_create("/tmp/ncodec/no/such/file", "r"));
+}
+
+
+int run_file_tests(void)
+{
+    void* s = test_setup;
+    void* t = test_teardown;
+
+    const struct CMUnitTest file_tests[] = {
+        cmocka_unit_test_setup_teardown(test_file_record_replay, s, t),
+        cmocka_unit_test_setup_teardown(test_file_record_steps, s, t),
+        cmocka_unit_test_setup_teardown(test_file_append, s, t),
+    };
+
+    return cmocka_run_group_tests_name("FILE", file_tests, NULL, NULL);
+}
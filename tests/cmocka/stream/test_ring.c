@@ -0,0 +1,204 @@
+// Copyright 2025 Robert Bosch GmbH
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#include <dse/testing.h>
+#include <errno.h>
+#include <stdio.h>
+#include <dse/ncodec/codec.h>
+#include <dse/ncodec/stream/stream.h>
+
+
+#define UNUSED(x)     ((void)x)
+#define ARRAY_SIZE(x) (sizeof(x) / sizeof(x[0]))
+#define RING_LEN      256
+
+
+typedef struct Mock {
+    NCodecInstance tx;
+    NCodecInstance rx;
+} Mock;
+
+
+static int test_setup(void** state)
+{
+    Mock* mock = calloc(1, sizeof(Mock));
+    assert_non_null(mock);
+
+    mock->tx.stream = ncodec_ring_stream_create(RING_LEN - 10);
+    assert_non_null(mock->tx.stream);
+    mock->tx.stream_ext = ncodec_stream_ext(mock->tx.stream);
+    mock->rx.stream = ncodec_ring_stream_share(mock->tx.stream);
+    assert_non_null(mock->rx.stream);
+
+    *state = mock;
+    return 0;
+}
+
+
+static int test_teardown(void** state)
+{
+    Mock* mock = *state;
+    if (mock && mock->tx.stream) mock->tx.stream->close((void*)&mock->tx);
+    if (mock && mock->rx.stream) mock->rx.stream->close((void*)&mock->rx);
+    if (mock) free(mock);
+
+    return 0;
+}
+
+
+void test_ring_readwrite(void** state)
+{
+    Mock*   mock = *state;
+    NCODEC* tx = (void*)&mock->tx;
+    NCODEC* rx = (void*)&mock->rx;
+    size_t  rc;
+
+    uint8_t* buffer;
+    size_t   len;
+    rc = mock->rx.stream->read(rx, &buffer, &len, NCODEC_POS_NC);
+    assert_int_equal(rc, 0);
+    assert_null(buffer);
+    assert_int_equal(mock->rx.stream->eof(rx), 1);
+
+    /* Write, then read (consume) the messages. */
+    rc = mock->tx.stream->write(tx, (uint8_t*)"hello", 5);
+    assert_int_equal(rc, 5);
+    rc = mock->tx.stream->write(tx, (uint8_t*)"world", 5);
+    assert_int_equal(rc, 5);
+    assert_int_equal(mock->rx.stream->eof(rx), 0);
+    rc = mock->rx.stream->read(rx, &buffer, &len, NCODEC_POS_NC);
+    assert_int_equal(rc, 10);
+    assert_memory_equal(buffer, "helloworld", 10);
+    mock->rx.stream->seek(rx, 5, NCODEC_SEEK_CUR);
+    assert_int_equal(mock->rx.stream->tell(rx), 5);
+    rc = mock->rx.stream->read(rx, &buffer, &len, NCODEC_POS_UPDATE);
+    assert_int_equal(rc, 5);
+    assert_memory_equal(buffer, "world", 5);
+    assert_int_equal(mock->rx.stream->eof(rx), 1);
+
+    /* Seek to the start (content is retained until released). */
+    mock->rx.stream->seek(rx, 0, NCODEC_SEEK_SET);
+    rc = mock->rx.stream->read(rx, &buffer, &len, NCODEC_POS_NC);
+    assert_int_equal(rc, 10);
+    mock->rx.stream->seek(rx, 0, NCODEC_SEEK_END);
+    mock->rx.stream->seek(rx, 0, NCODEC_SEEK_RESET);
+    assert_int_equal(mock->rx.stream->tell(rx), 0);
+    rc = mock->rx.stream->read(rx, &buffer, &len, NCODEC_POS_NC);
+    assert_int_equal(rc, 0);
+}
+
+
+void test_ring_wrap(void** state)
+{
+    Mock*   mock = *state;
+    NCODEC* tx = (void*)&mock->tx;
+    NCODEC* rx = (void*)&mock->rx;
+    int32_t rc;
+
+    uint8_t msg[100];
+    for (uint32_t i = 0; i < sizeof(msg); i++)
+        msg[i] = i;
+
+    /* Continuous traffic, several times the ring capacity. */
+    for (uint32_t i = 0; i < 20; i++) {
+        msg[0] = i;
+        rc = mock->tx.stream->write(tx, msg, sizeof(msg));
+        assert_int_equal(rc, sizeof(msg));
+
+        uint8_t* buffer;
+        size_t   len;
+        rc = mock->rx.stream->read(rx, &buffer, &len, NCODEC_POS_UPDATE);
+        assert_int_equal(rc, sizeof(msg));
+        assert_int_equal(buffer[0], i);
+        assert_memory_equal(&buffer[1], &msg[1], sizeof(msg) - 1);
+        mock->rx.stream->seek(rx, 0, NCODEC_SEEK_RESET);
+    }
+}
+
+
+void test_ring_full(void** state)
+{
+    Mock*   mock = *state;
+    NCODEC* tx = (void*)&mock->tx;
+    NCODEC* rx = (void*)&mock->rx;
+    int32_t rc;
+
+    uint8_t msg[100] = {};
+    uint8_t big[RING_LEN + 1] = {};
+
+    rc = mock->tx.stream->write(tx, big, sizeof(big));
+    assert_int_equal(rc, -EMSGSIZE);
+    rc = mock->tx.stream->write(tx, msg, sizeof(msg));
+    assert_int_equal(rc, sizeof(msg));
+    rc = mock->tx.stream->write(tx, msg, sizeof(msg));
+    assert_int_equal(rc, sizeof(msg));
+    /* No space before the end, and no space at the start (not released). */
+    rc = mock->tx.stream->write(tx, msg, sizeof(msg));
+    assert_int_equal(rc, -EMSGSIZE);
+
+    /* Consume (but not release) the first message. */
+    mock->rx.stream->seek(rx, sizeof(msg), NCODEC_SEEK_CUR);
+    rc = mock->tx.stream->write(tx, msg, sizeof(msg));
+    assert_int_equal(rc, -EMSGSIZE);
+
+    /* Release, now the message is written at the start of the ring. */
+    mock->rx.stream->seek(rx, 0, NCODEC_SEEK_RESET);
+    msg[0] = 42;
+    rc = mock->tx.stream->write(tx, msg, sizeof(msg));
+    assert_int_equal(rc, sizeof(msg));
+
+    /* Read: second message, then (after the padding) the third message. */
+    uint8_t* buffer;
+    size_t   len;
+    rc = mock->rx.stream->read(rx, &buffer, &len, NCODEC_POS_UPDATE);
+    assert_int_equal(rc, sizeof(msg));
+    assert_int_equal(buffer[0], 0);
+    rc = mock->rx.stream->read(rx, &buffer, &len, NCODEC_POS_UPDATE);
+    assert_int_equal(rc, sizeof(msg));
+    assert_int_equal(buffer[0], 42);
+    rc = mock->rx.stream->read(rx, &buffer, &len, NCODEC_POS_UPDATE);
+    assert_int_equal(rc, 0);
+}
+
+
+void test_ring_reserve(void** state)
+{
+    Mock*   mock = *state;
+    NCODEC* tx = (void*)&mock->tx;
+    NCODEC* rx = (void*)&mock->rx;
+    int32_t rc;
+
+    /* Reserved content is not visible until committed. */
+    uint8_t* data;
+    rc = mock->tx.stream_ext->reserve(tx, 64, &data);
+    assert_int_equal(rc, 0);
+    memset(data, 0x55, 64);
+    assert_int_equal(mock->rx.stream->eof(rx), 1);
+    rc = mock->tx.stream_ext->commit(tx, 32);
+    assert_int_equal(rc, 32);
+    rc = mock->tx.stream_ext->commit(tx, 32);
+    assert_int_equal(rc, -EINVAL);
+
+    uint8_t* buffer;
+    size_t   len;
+    rc = mock->rx.stream->read(rx, &buffer, &len, NCODEC_POS_UPDATE);
+    assert_int_equal(rc, 32);
+    assert_ptr_equal(buffer, data);
+}
+
+
+int run_ring_tests(void)
+{
+    void* s = test_setup;
+    void* t = test_teardown;
+
+    const struct CMUnitTest ring_tests[] = {
+        cmocka_unit_test_setup_teardown(test_ring_readwrite, s, t),
+        cmocka_unit_test_setup_teardown(test_ring_wrap, s, t),
+        cmocka_unit_test_setup_teardown(test_ring_full, s, t),
+        cmocka_unit_test_setup_teardown(test_ring_reserve, s, t),
+    };
+
+    return cmocka_run_group_tests_name("RING", ring_tests, NULL, NULL);
+}
@@ -0,0 +1,155 @@
+// Copyright 2025 Robert Bosch GmbH
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#include <dse/testing.h>
+#include <errno.h>
+#include <stdio.h>
+#include <unistd.h>
+#include <sys/wait.h>
+#include <dse/ncodec/codec.h>
+#include <dse/ncodec/stream/stream.h>
+
+
+#define UNUSED(x)     ((void)x)
+#define ARRAY_SIZE(x) (sizeof(x) / sizeof(x[0]))
+#define RING_LEN      4096
+
+
+typedef struct Mock {
+    char           name[64];
+    NCodecInstance tx;
+    NCodecInstance rx;
+} Mock;
+
+
+static int test_setup(void** state)
+{
+    Mock* mock = calloc(1, sizeof(Mock));
+    assert_non_null(mock);
+
+    snprintf(mock->name, sizeof(mock->name), "/ncodec.test.%d", getpid());
+    mock->tx.stream = ncodec_shm_stream_create(mock->name, RING_LEN);
+    assert_non_null(mock->tx.stream);
+    mock->rx.stream = ncodec_shm_stream_create(mock->name, 0);
+    assert_non_null(mock->rx.stream);
+
+    *state = mock;
+    return 0;
+}
+
+
+static int test_teardown(void** state)
+{
+    Mock* mock = *state;
+    if (mock && mock->tx.stream) mock->tx.stream->close((void*)&mock->tx);
+    if (mock && mock->rx.stream) mock->rx.stream->close((void*)&mock->rx);
+    if (mock) free(mock);
+
+    return 0;
+}
+
+
+void test_shm_readwrite(void** state)
+{
+    Mock*   mock = *state;
+    NCODEC* tx = (void*)&mock->tx;
+    NCODEC* rx = (void*)&mock->rx;
+    size_t  rc;
+
+    rc = mock->tx.stream->write(tx, (uint8_t*)"hello", 5);
+    assert_int_equal(rc, 5);
+
+    uint8_t* buffer;
+    size_t   len;
+    rc = mock->rx.stream->read(rx, &buffer, &len, NCODEC_POS_UPDATE);
+    assert_int_equal(rc, 5);
+    assert_memory_equal(buffer, "hello", 5);
+    assert_int_equal(mock->rx.stream->eof(rx), 1);
+    mock->rx.stream->seek(rx, 0, NCODEC_SEEK_RESET);
+}
+
+
+void test_shm_owner(void** state)
+{
+    Mock*   mock = *state;
+    NCODEC* tx = (void*)&mock->tx;
+    NCODEC* rx = (void*)&mock->rx;
+    size_t  rc;
+
+    rc = mock->tx.stream->write(tx, (uint8_t*)"hello", 5);
+    assert_int_equal(rc, 5);
+
+    /* The creator removes the segment, connected streams continue. */
+    mock->tx.stream->close(tx);
+    assert_null(mock->tx.stream);
+    assert_null(ncodec_shm_stream_create(mock->name, 0));
+
+    uint8_t* buffer;
+    size_t   len;
+    rc = mock->rx.stream->read(rx, &buffer, &len, NCODEC_POS_UPDATE);
+    assert_int_equal(rc, 5);
+    assert_memory_equal(buffer, "hello", 5);
+}
+
+
+void test_shm_process(void** state)
+{
+    Mock*   mock = *state;
+    NCODEC* rx = (void*)&mock->rx;
+
+    /* Producer process, connects to the existing segment. */
+    pid_t pid = fork();
+    assert_true(pid >= 0);
+    if (pid == 0) {
+        NCodecInstance tx = {
+            .stream = ncodec_shm_stream_create(mock->name, 0)
+        };
+        if (tx.stream == NULL) _exit(1);
+        for (uint32_t i = 0; i < 1000; i++) {
+            while ((int32_t)tx.stream->write((void*)&tx, (uint8_t*)&i,
+                       sizeof(i)) == -EMSGSIZE) {
+                usleep(100);
+            }
+        }
+        tx.stream->close((void*)&tx);
+        _exit(0);
+    }
+
+    /* Consumer. */
+    uint32_t expect = 0;
+    while (expect < 1000) {
+        uint8_t* buffer;
+        size_t   len;
+        if (mock->rx.stream->read(rx, &buffer, &len, NCODEC_POS_UPDATE) == 0) {
+            usleep(100);
+            continue;
+        }
+        assert_int_equal(len % sizeof(uint32_t), 0);
+        for (size_t i = 0; i < len; i += sizeof(uint32_t)) {
+            uint32_t value;
+            memcpy(&value, &buffer[i], sizeof(value));
+            assert_int_equal(value, expect++);
+        }
+        mock->rx.stream->seek(rx, 0, NCODEC_SEEK_RESET);
+    }
+    int status;
+    waitpid(pid, &status, 0);
+    assert_true(WIFEXITED(status));
+    assert_int_equal(WEXITSTATUS(status), 0);
+}
+
+
+int run_shm_tests(void)
+{
+    void* s = test_setup;
+    void* t = test_teardown;
+
+    const struct CMUnitTest shm_tests[] = {
+        cmocka_unit_test_setup_teardown(test_shm_readwrite, s, t),
+        cmocka_unit_test_setup_teardown(test_shm_owner, s, t),
+        cmocka_unit_test_setup_teardown(test_shm_process, s, t),
+    };
+
+    return cmocka_run_group_tests_name("SHM", shm_tests, NULL, NULL);
+}
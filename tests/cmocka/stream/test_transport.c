@@ -0,0 +1,93 @@
+// Copyright 2025 Robert Bosch GmbH
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#include <dse/testing.h>
+#include <errno.h>
+#include <string.h>
+#include <dse/ncodec/stream/stream.h>
+#include <dse/ncodec/stream/transport.h>
+
+
+#define UNUSED(x)     ((void)x)
+#define ARRAY_SIZE(x) (sizeof(x) / sizeof(x[0]))
+
+
+void test_transport_lookup(void** state)
+{
+    UNUSED(state);
+
+    const NCodecTransport* t = ncodec_transport(NULL);
+    assert_non_null(t);
+    assert_string_equal(t->name, "ascii85");
+    assert_true(t->text);
+    assert_ptr_equal(ncodec_transport("ascii85"), t);
+    assert_non_null(ncodec_transport("base64"));
+    assert_true(ncodec_transport("base64")->text);
+    assert_non_null(ncodec_transport("binary"));
+    assert_false(ncodec_transport("binary")->text);
+    assert_null(ncodec_transport("base32"));
+}
+
+
+void test_transport_roundtrip(void** state)
+{
+    UNUSED(state);
+    const char* names[] = { "ascii85", "base64", "binary" };
+    uint8_t     data[300];
+
+    for (size_t i = 0; i < sizeof(data); i++) {
+        data[i] = (i % 7) ? i * 13 : 0;
+    }
+    for (size_t n = 0; n < ARRAY_SIZE(names); n++) {
+        const NCodecTransport* t = ncodec_transport(names[n]);
+        assert_non_null(t);
+        for (size_t len = 0; len < sizeof(data); len += 11) {
+            size_t en_len = 0;
+            char*  en = ncodec_transport_encode(t, data, len, &en_len);
+            assert_non_null(en);
+            assert_true(en_len <= t->encode_len(len));
+            assert_int_equal(en[en_len], '\0');
+            if (t->text) assert_int_equal(strlen(en), en_len);
+
+            size_t   de_len = 0;
+            uint8_t* de = ncodec_transport_decode(t, en, en_len, &de_len);
+            assert_non_null(de);
+            assert_int_equal(de_len, len);
+            assert_memory_equal(de, data, len);
+            free(de);
+            free(en);
+        }
+    }
+}
+
+
+void test_transport_base64(void** state)
+{
+    UNUSED(state);
+    const NCodecTransport* t = ncodec_transport("base64");
+    char                   en[16];
+    uint8_t                de[16];
+
+    assert_int_equal(t->encode((uint8_t*)"hello", 5, en, sizeof(en)), 8);
+    assert_string_equal(en, "aGVsbG8=");
+    assert_int_equal(t->encode((uint8_t*)"hello", 5, en, 7), -EMSGSIZE);
+    assert_int_equal(t->decode(en, 8, de, sizeof(de)), 5);
+    assert_memory_equal(de, "hello", 5);
+    assert_int_equal(t->decode("aGV$bG8=", 8, de, sizeof(de)), -EBADMSG);
+}
+
+
+int run_transport_tests(void)
+{
+    void* s = NULL;
+    void* t = NULL;
+
+    const struct CMUnitTest transport_tests[] = {
+        cmocka_unit_test_setup_teardown(test_transport_lookup, s, t),
+        cmocka_unit_test_setup_teardown(test_transport_roundtrip, s, t),
+        cmocka_unit_test_setup_teardown(test_transport_base64, s, t),
+    };
+
+    return cmocka_run_group_tests_name("TRANSPORT", transport_tests, NULL, NULL);
+}